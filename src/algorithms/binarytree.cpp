@@ -0,0 +1,15 @@
+#include "binarytree.h"
+
+void BinaryTree::CarveRow(int row, int columns, const uint64_t* bits,
+                          Random&, char* left, char* down) const {
+  // The first row can only go left and the first column only down
+  if (row == 0) {
+    for (int column = 1; column < columns; ++column) left[column] = 1;
+    return;
+  }
+  down[0] = 1;
+  for (int column = 1; column < columns; ++column) {
+    bool bit = (bits[column >> 6] >> (column & 63)) & 1;
+    (bit ? left : down)[column] = 1;
+  }
+}
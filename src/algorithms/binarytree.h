@@ -0,0 +1,13 @@
+#ifndef BINARYTREE_H
+#define BINARYTREE_H
+
+#include "rowalgorithm.h"
+
+// Every cell opens the wall on its left or below it, chosen by a coin flip,
+// which leaves long straight corridors along the first row and column
+class BinaryTree : public RowAlgorithm {
+ protected:
+  void CarveRow(int, int, const uint64_t*, Random&, char*, char*) const;
+};
+
+#endif /* end of include guard: BINARYTREE_H */
@@ -0,0 +1,38 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <cstdint>
+#include <vector>
+
+// Fixed size set of bits packed into 64 bit words. Set bits can be visited
+// a word at a time, skipping empty words without testing every bit.
+class Bitset {
+ public:
+  Bitset(int size = 0, bool value = false) { Assign(size, value); }
+
+  void Assign(int size, bool value) {
+    size_ = size;
+    words_.assign((size + 63) / 64, value ? ~uint64_t(0) : 0);
+    // Keep the bits past the end clear so whole words can be scanned
+    if (value and size % 64 != 0) words_.back() >>= 64 - size % 64;
+  }
+  int Size() const { return size_; }
+  bool Test(int i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+  void Set(int i) { words_[i >> 6] |= uint64_t(1) << (i & 63); }
+  void Reset(int i) { words_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+  // Calls f(i) for every set bit i in increasing order
+  template <typename Function>
+  void ForEach(Function f) const {
+    for (int w = 0; w < int(words_.size()); ++w) {
+      for (uint64_t word = words_[w]; word != 0; word &= word - 1)
+        f(64 * w + __builtin_ctzll(word));
+    }
+  }
+
+ private:
+  int size_;
+  std::vector<uint64_t> words_;
+};
+
+#endif /* end of include guard: BITSET_H */
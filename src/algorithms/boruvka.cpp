@@ -0,0 +1,140 @@
+#include "boruvka.h"
+#include "parallel.h"
+#include <algorithm>
+
+namespace {
+const uint64_t none = ~uint64_t(0);
+}
+
+void Boruvka::SpanningTree(int vertices, const Graph& adjacencylist,
+                           EdgeSink& sink) {
+  weightkeys_[0] = generator();
+  weightkeys_[1] = generator();
+  if (capacity_ < vertices) {
+    capacity_ = vertices;
+    parent_.reset(new std::atomic<int>[vertices]);
+    lightest_.reset(new std::atomic<uint64_t>[vertices]);
+  }
+
+  // Vertex chunks are the unit of work for every parallel step, each thread
+  // with its own neighbor buffers
+  const int chunksize = 1 << 14;
+  int chunks = (vertices + chunksize - 1) / chunksize;
+  auto& buffers = NeighborBuffers(adjacencylist);
+  auto forvertices = [&](auto body) {
+    ParallelFor(chunks, [&](int chunk) {
+      auto& buffer = buffers[Worker()];
+      int end = std::min(vertices, (chunk + 1) * chunksize);
+      for (int u = chunk * chunksize; u < end; ++u)
+        body(u, buffer.neighbors.data(), buffer.edgeids.data());
+    });
+  };
+  forvertices([&](int u, int*, int*) {
+    parent_[u].store(u, std::memory_order_relaxed);
+  });
+
+  from_.resize(vertices);
+  to_.resize(vertices);
+  edgeid_.resize(vertices);
+  internal_.assign(vertices, 0);
+  for (bool merged = true; merged;) {
+    // Flatten the forest so that the scan below finds roots in one step
+    forvertices([&](int u, int*, int*) {
+      parent_[u].store(Find(u), std::memory_order_relaxed);
+      lightest_[u].store(none, std::memory_order_relaxed);
+    });
+
+    forvertices([&](int u, int* neighbors, int* edgeids) {
+      if (internal_[u]) return;
+      int ru = parent_[u].load(std::memory_order_relaxed);
+      int degree = adjacencylist.Neighbors(u, neighbors, edgeids);
+      uint64_t best = none;
+      for (int i = 0; i < degree; ++i) {
+        if (parent_[neighbors[i]].load(std::memory_order_relaxed) == ru)
+          continue;
+        best = std::min(best, uint64_t(Weight(edgeids[i])) << 32 | u);
+      }
+      if (best == none) {
+        internal_[u] = 1;
+        return;
+      }
+      uint64_t current = lightest_[ru].load(std::memory_order_relaxed);
+      while (best < current and
+             !lightest_[ru].compare_exchange_weak(current, best,
+                                                  std::memory_order_relaxed))
+        ;
+    });
+
+    // Recover the lightest edges. When two components pick the same edge only
+    // the lower root keeps it, the remaining edges then form a forest.
+    forvertices([&](int r, int* neighbors, int* edgeids) {
+      edgeid_[r] = -1;
+      uint64_t best = lightest_[r].load(std::memory_order_relaxed);
+      if (best == none) return;
+      int u = best & 0xffffffff;
+      int degree = adjacencylist.Neighbors(u, neighbors, edgeids);
+      for (int i = 0; i < degree; ++i) {
+        if (Weight(edgeids[i]) != best >> 32) continue;
+        int rv = parent_[neighbors[i]].load(std::memory_order_relaxed);
+        uint64_t other = lightest_[rv].load(std::memory_order_relaxed);
+        if (other >> 32 == best >> 32 and rv < r) return;
+        from_[r] = u;
+        to_[r] = neighbors[i];
+        edgeid_[r] = edgeids[i];
+        return;
+      }
+    });
+
+    forvertices([&](int r, int*, int*) {
+      if (edgeid_[r] >= 0) Unite(from_[r], to_[r]);
+    });
+
+    merged = false;
+    for (int r = 0; r < vertices; ++r) {
+      if (edgeid_[r] < 0) continue;
+      sink.AddEdge(from_[r], to_[r], edgeid_[r]);
+      merged = true;
+    }
+  }
+}
+
+uint32_t Boruvka::Weight(int edgeid) const {
+  // Every step is invertible on 32 bit integers
+  uint32_t x = uint32_t(edgeid) ^ weightkeys_[0];
+  x *= 0x9e3779b1u;
+  x ^= x >> 16;
+  x += weightkeys_[1];
+  x *= 0x85ebca6bu;
+  x ^= x >> 13;
+  x *= 0xc2b2ae35u;
+  x ^= x >> 16;
+  return x;
+}
+
+int Boruvka::Find(int u) {
+  // Path halving, concurrent finds only ever shortcut to an ancestor
+  while (true) {
+    int parent = parent_[u].load(std::memory_order_relaxed);
+    if (parent == u) return u;
+    int grandparent = parent_[parent].load(std::memory_order_relaxed);
+    if (grandparent != parent)
+      parent_[u].compare_exchange_weak(parent, grandparent,
+                                       std::memory_order_relaxed);
+    u = grandparent;
+  }
+}
+
+void Boruvka::Unite(int u, int v) {
+  while (true) {
+    u = Find(u);
+    v = Find(v);
+    if (u == v) return;
+    if (u < v) std::swap(u, v);
+    // Link the higher root below the lower one, retry if u stopped being a
+    // root in the meantime
+    int expected = u;
+    if (parent_[u].compare_exchange_strong(expected, v,
+                                           std::memory_order_acq_rel))
+      return;
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef BORUVKA_H
+#define BORUVKA_H
+
+#include "spanningtreealgorithm.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Minimum spanning tree under random edge weights, built in Borůvka rounds
+// spread over the worker threads. The tree is the one Kruskal's algorithm
+// would build on the edges sorted by weight.
+class Boruvka : public SpanningtreeAlgorithm {
+ public:
+  void SpanningTree(int, const Graph&, EdgeSink&);
+
+ private:
+  uint32_t weightkeys_[2];
+  // The arrays below are kept between trees, parent_ and lightest_ hold
+  // capacity_ entries
+  int capacity_ = 0;
+  // Concurrent union-find, roots always link to the lower index root so the
+  // root of a component is its lowest vertex
+  std::unique_ptr<std::atomic<int>[]> parent_;
+  // Lightest edge leaving each component, as weight << 32 | vertex
+  std::unique_ptr<std::atomic<uint64_t>[]> lightest_;
+  // Edge leaving each component this round, as the vertex inside it, the
+  // vertex outside and the edge id
+  std::vector<int> from_, to_, edgeid_;
+  // Components only grow, so once all neighbors of a vertex are in its own
+  // component it can be skipped for good
+  std::vector<char> internal_;
+
+  // Random bijection of edge ids, so that weights never tie
+  uint32_t Weight(int) const;
+  int Find(int);
+  void Unite(int, int);
+};
+
+#endif /* end of include guard: BORUVKA_H */
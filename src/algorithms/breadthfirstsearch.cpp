@@ -1,31 +1,116 @@
 #include "breadthfirstsearch.h"
+#include "parallel.h"
 #include <algorithm>
-#include <iostream>
 
-std::vector<std::pair<int, int>> BreadthFirstSearch::SpanningTree(
-    int vertices, const Graph& adjacencylist) {
-  visited = std::vector<bool>(vertices, false);
+void BreadthFirstSearch::SpanningTree(int vertices, const Graph& adjacencylist,
+                                      EdgeSink& sink) {
+  if (vertices == 0) return;
+  prioritykeys[0] = generator();
+  prioritykeys[1] = generator();
+  int words = (vertices + 63) / 64;
+  if (capacity < vertices) {
+    capacity = vertices;
+    visited.reset(new std::atomic<uint64_t>[words]);
+    best.reset(new std::atomic<uint32_t>[vertices]);
+  }
+  for (int w = 0; w < words; ++w) visited[w].store(0);
+  for (int u = 0; u < vertices; ++u) best[u].store(~uint32_t(0));
+
+  currentlevel.assign(1, RandomIndex(vertices));
+  TestAndSet(currentlevel[0]);
 
-  int startvertex =
-      std::uniform_int_distribution<int>(0, vertices - 1)(generator);
-  currentlevel.push_back(startvertex);
-  visited[startvertex] = true;
+  // Levels are split into fixed chunks, each thread with its own neighbor
+  // buffers
+  const int chunksize = 1 << 10;
+  auto& buffers = NeighborBuffers(adjacencylist);
+  auto chunks = [&]() {
+    return int(currentlevel.size() + chunksize - 1) / chunksize;
+  };
+  auto forchunks = [&](auto body) {
+    ParallelFor(chunks(), [&](int chunk) {
+      auto& buffer = buffers[Worker()];
+      int end = std::min<int>(currentlevel.size(), (chunk + 1) * chunksize);
+      for (int i = chunk * chunksize; i < end; ++i) {
+        body(chunk, currentlevel[i], buffer.neighbors.data(),
+             buffer.edgeids.data());
+      }
+    });
+  };
 
-  spanningtree.clear();
   while (!currentlevel.empty()) {
-    for (auto vertex : currentlevel) {
-      for (const auto& edge : adjacencylist[vertex]) {
-        int nextvertex = std::get<0>(edge);
-        if (nextvertex < 0 or visited[nextvertex]) continue;
-        visited[nextvertex] = true;
-        spanningtree.push_back({vertex, nextvertex});
-        nextlevel.push_back(nextvertex);
+    // Every unvisited neighbor of the level keeps the lowest priority among
+    // its neighbors in the level. Priorities do not depend on the order of
+    // the level, which takes the place of shuffling it.
+    if (int(candidates.size()) < chunks()) candidates.resize(chunks());
+    forchunks([&](int chunk, int vertex, int* neighbors, int* edgeids) {
+      uint32_t priority = Priority(vertex);
+      int degree = adjacencylist.Neighbors(vertex, neighbors, edgeids);
+      for (int i = 0; i < degree; ++i) {
+        int next = neighbors[i];
+        if (Visited(next)) continue;
+        uint32_t current = best[next].load(std::memory_order_relaxed);
+        while (priority < current and
+               !best[next].compare_exchange_weak(current, priority,
+                                                 std::memory_order_relaxed))
+          ;
+        if (priority < current)
+          candidates[chunk].push_back({vertex, next, edgeids[i]});
       }
-    }
+    });
 
-    currentlevel.clear();
+    // Every chunk claims the new vertices whose lowest priority is one of
+    // its own and keeps only those edges. The winner of a vertex is unique,
+    // so the edges come out in level order whatever the threads do.
+    int count = chunks();
+    ParallelEdges(count, [&](int chunk, EdgeSink& chunksink) {
+      auto& edges = candidates[chunk];
+      size_t winners = 0;
+      for (const Edge& edge : edges) {
+        if (best[edge.to].load(std::memory_order_relaxed) !=
+                Priority(edge.from) or
+            TestAndSet(edge.to))
+          continue;
+        chunksink.AddEdge(edge.from, edge.to, edge.edgeid);
+        edges[winners++] = edge;
+      }
+      edges.resize(winners);
+    }, sink);
+
+    // The claimed vertices of the chunks, one after the other, are the
+    // next level
+    offsets.resize(count + 1);
+    offsets[0] = 0;
+    for (int chunk = 0; chunk < count; ++chunk)
+      offsets[chunk + 1] = offsets[chunk] + candidates[chunk].size();
+    nextlevel.resize(offsets[count]);
+    ParallelFor(count, [&](int chunk) {
+      int i = offsets[chunk];
+      for (const Edge& edge : candidates[chunk]) nextlevel[i++] = edge.to;
+      candidates[chunk].clear();
+    });
     swap(currentlevel, nextlevel);
-    shuffle(currentlevel.begin(), currentlevel.end(), generator);
   }
-  return spanningtree;
+}
+
+uint32_t BreadthFirstSearch::Priority(int vertex) const {
+  // Every step is invertible on 32 bit integers
+  uint32_t x = uint32_t(vertex) ^ prioritykeys[0];
+  x *= 0x9e3779b1u;
+  x ^= x >> 16;
+  x += prioritykeys[1];
+  x *= 0x85ebca6bu;
+  x ^= x >> 13;
+  x *= 0xc2b2ae35u;
+  x ^= x >> 16;
+  return x;
+}
+
+bool BreadthFirstSearch::Visited(int vertex) const {
+  uint64_t word = visited[vertex >> 6].load(std::memory_order_relaxed);
+  return word >> (vertex & 63) & 1;
+}
+
+bool BreadthFirstSearch::TestAndSet(int vertex) {
+  uint64_t bit = uint64_t(1) << (vertex & 63);
+  return visited[vertex >> 6].fetch_or(bit, std::memory_order_relaxed) & bit;
 }
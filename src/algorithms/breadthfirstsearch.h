@@ -2,15 +2,43 @@
 #define BREADTHFIRSTSEARCH_H
 
 #include "spanningtreealgorithm.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+// Grows the tree one level at a time, every vertex of the next level is
+// attached to a random neighbor in the current level. Levels are expanded
+// on the worker threads, the tree does not depend on their number.
 class BreadthFirstSearch : public SpanningtreeAlgorithm {
  public:
-  std::vector<std::pair<int, int>> SpanningTree(int, const Graph&);
+  void SpanningTree(int, const Graph&, EdgeSink&);
 
  private:
-  std::vector<bool> visited;
+  struct Edge {
+    int from, to, edgeid;
+  };
+
+  uint32_t prioritykeys[2];
+  // The arrays below are kept between searches, visited and best hold
+  // capacity entries
+  int capacity = 0;
+  std::unique_ptr<std::atomic<uint64_t>[]> visited;
+  // Lowest priority among the neighbors of each vertex in the current level
+  std::unique_ptr<std::atomic<uint32_t>[]> best;
   std::vector<int> currentlevel, nextlevel;
+  // Edges to the next level found by each chunk of the current level that
+  // lowered the priority of their end, and then only those which won it
+  std::vector<std::vector<Edge>> candidates;
+  // Start of the vertices claimed by each chunk in the next level
+  std::vector<int> offsets;
+
+  // Random bijection of vertices, the neighbor with the lowest priority in
+  // the level above becomes the parent
+  uint32_t Priority(int) const;
+  bool Visited(int) const;
+  // Marks a vertex as visited, returns whether it already was
+  bool TestAndSet(int);
 };
 
 #endif /* end of include guard: BREADTHFIRSTSEARCH_H */
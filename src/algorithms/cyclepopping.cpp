@@ -0,0 +1,166 @@
+#include "cyclepopping.h"
+#include "parallel.h"
+#include <algorithm>
+
+namespace {
+// Vertices without a claim have either a top arrow that was popped and is
+// drawn again when they are next claimed, or an arrow that is still valid
+const int popped = 0, intree = -1, valid = -2;
+// Path of a blocked walk, in the way of other walks until the round ends
+const int blocked = -3;
+}  // namespace
+
+void CyclePopping::SpanningTree(int vertices, const Graph& adjacencylist,
+                                EdgeSink& sink) {
+  seed_ = generator();
+  if (capacity_ < vertices) {
+    capacity_ = vertices;
+    state_.reset(new std::atomic<int>[vertices]);
+  }
+  next_.assign(vertices, -1);
+  nextedge_.resize(vertices);
+  claimed_.resize(vertices);
+  // Arrows are drawn lazily, so every vertex starts at depth -1 with its
+  // first arrow pending
+  depth_.assign(vertices, uint32_t(-1));
+  active_.resize(vertices);
+
+  const int chunksize = 1 << 12;
+  int chunks = (vertices + chunksize - 1) / chunksize;
+  activecount_.assign(chunks, 0);
+  if (int(workspaces_.size()) < Threads()) workspaces_.resize(Threads());
+  for (auto& workspace : workspaces_) {
+    workspace.neighbors.resize(adjacencylist.MaxDegree());
+    workspace.edgeids.resize(adjacencylist.MaxDegree());
+  }
+  auto forchunks = [&](auto body) {
+    ParallelFor(chunks,
+                [&](int chunk) { body(chunk, workspaces_[Worker()]); });
+  };
+
+  // Isolated vertices are roots of their own
+  forchunks([&](int chunk, Workspace& workspace) {
+    int end = std::min(vertices, (chunk + 1) * chunksize);
+    for (int u = chunk * chunksize; u < end; ++u) {
+      if (adjacencylist.Neighbors(u, workspace.neighbors.data(),
+                                  workspace.edgeids.data()) == 0) {
+        state_[u].store(intree, std::memory_order_relaxed);
+        continue;
+      }
+      state_[u].store(popped, std::memory_order_relaxed);
+      active_[chunk * chunksize + activecount_[chunk]++] = u;
+    }
+  });
+  // Any root gives a uniform tree
+  if (vertices > 0) state_[RandomIndex(vertices)].store(intree);
+
+  // Every round starts a walk from each vertex that is still free. Walks
+  // stop at vertices claimed by other walks, so paths left by blocked walks
+  // are walked again in the next round. A round that gets nowhere is
+  // repeated on a single thread, which always completes the tree.
+  for (bool done = false, serial = false; !done;) {
+    std::atomic<long long> progress(0);
+    auto round = [&](int chunk, Workspace& workspace) {
+      long long draws = 0;
+      int* active = &active_[chunk * chunksize];
+      for (int i = 0; i < activecount_[chunk]; ++i) {
+        int state = state_[active[i]].load(std::memory_order_acquire);
+        if (state == popped or state == valid)
+          draws += Walk(active[i], adjacencylist, workspace);
+      }
+      progress += draws;
+    };
+    if (serial) {
+      for (int chunk = 0; chunk < chunks; ++chunk)
+        round(chunk, workspaces_[Worker()]);
+    } else {
+      forchunks(round);
+    }
+
+    std::atomic<bool> remaining(false);
+    forchunks([&](int chunk, Workspace&) {
+      int* active = &active_[chunk * chunksize];
+      int count = 0;
+      for (int i = 0; i < activecount_[chunk]; ++i) {
+        int state = state_[active[i]].load(std::memory_order_relaxed);
+        if (state == intree) continue;
+        if (state == blocked)
+          state_[active[i]].store(valid, std::memory_order_relaxed);
+        active[count++] = active[i];
+      }
+      activecount_[chunk] = count;
+      if (count > 0) remaining = true;
+    });
+    done = !remaining;
+    serial = progress == 0;
+  }
+
+  for (int u = 0; u < vertices; ++u) {
+    if (next_[u] >= 0) sink.AddEdge(next_[u], u, nextedge_[u]);
+  }
+}
+
+void CyclePopping::Arrow(int vertex, const Graph& adjacencylist,
+                         Workspace& workspace) {
+  int degree = adjacencylist.Neighbors(vertex, workspace.neighbors.data(),
+                                       workspace.edgeids.data());
+  // Lemire's bounded draw, rejected draws are rehashed
+  uint64_t hash =
+      Random::Mix(seed_ ^ (uint64_t(vertex) << 32 | ++depth_[vertex]));
+  uint64_t product = (hash >> 32) * uint32_t(degree);
+  uint32_t threshold = -uint32_t(degree) % uint32_t(degree);
+  while (uint32_t(product) < threshold) {
+    hash = Random::Mix(hash);
+    product = (hash >> 32) * uint32_t(degree);
+  }
+  int index = product >> 32;
+  next_[vertex] = workspace.neighbors[index];
+  nextedge_[vertex] = workspace.edgeids[index];
+}
+
+long long CyclePopping::Walk(int start, const Graph& adjacencylist,
+                             Workspace& workspace) {
+  // As in Wilson's algorithm the walk draws the next arrow whenever it
+  // comes back to a vertex, which pops the loop it closed. The other
+  // vertices on the loop stay claimed with their arrows pending.
+  const int owner = start + 1;
+  int claimed = -1;
+  long long draws = 0;
+  int vertex = start;
+  while (true) {
+    int state = state_[vertex].load(std::memory_order_acquire);
+    if (state == owner) {
+      Arrow(vertex, adjacencylist, workspace);
+      ++draws;
+    } else if ((state == popped or state == valid) and
+               state_[vertex].compare_exchange_strong(
+                   state, owner, std::memory_order_acquire)) {
+      claimed_[vertex] = claimed;
+      claimed = vertex;
+      if (state == popped) {
+        Arrow(vertex, adjacencylist, workspace);
+        ++draws;
+      }
+    } else if (state == intree or state == blocked or state > 0) {
+      break;
+    } else {
+      continue;
+    }
+    vertex = next_[vertex];
+  }
+
+  // The path from start either reached the tree or keeps its arrows for
+  // later walks. Loops that were popped along the way are left pending.
+  int state = state_[vertex].load(std::memory_order_relaxed);
+  int path = state == intree ? intree : blocked;
+  for (int u = start; u != vertex; u = next_[u])
+    state_[u].store(path, std::memory_order_release);
+  // The link is read before the claim is released to other walks
+  for (int u = claimed; u >= 0;) {
+    int next = claimed_[u];
+    if (state_[u].load(std::memory_order_relaxed) == owner)
+      state_[u].store(popped, std::memory_order_release);
+    u = next;
+  }
+  return draws;
+}
@@ -0,0 +1,49 @@
+#ifndef CYCLEPOPPING_H
+#define CYCLEPOPPING_H
+
+#include "spanningtreealgorithm.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Uniform spanning tree by Propp and Wilson's cycle popping. Every vertex
+// but the root has a stack of random arrows to its neighbors, and cycles
+// among the top arrows are popped until the top arrows form a tree. The tree
+// does not depend on the order of the pops, so walks on several threads can
+// pop disjoint cycles at once and still give the tree a single thread would.
+class CyclePopping : public SpanningtreeAlgorithm {
+ public:
+  void SpanningTree(int, const Graph&, EdgeSink&);
+
+ private:
+  struct Workspace {
+    std::vector<int> neighbors, edgeids;
+  };
+
+  uint64_t seed_;
+  // Everything below is kept between trees, state_ holds capacity_ entries
+  int capacity_ = 0;
+  // Either a claim by the walk started at owner - 1 or one of the states in
+  // cyclepopping.cpp
+  std::unique_ptr<std::atomic<int>[]> state_;
+  // Top arrow of every vertex and how many arrows were drawn before it
+  std::vector<int> next_, nextedge_;
+  // Vertices claimed by a walk as a list linked through the vertices, which
+  // only the walk holding their claim touches. Unlike a list per thread it
+  // never grows with the walks a thread happens to run.
+  std::vector<int> claimed_;
+  std::vector<uint32_t> depth_;
+  // Vertices not yet in the tree, kept per chunk at the front of the chunk
+  std::vector<int> active_, activecount_;
+  // Workspace of every thread
+  std::vector<Workspace> workspaces_;
+
+  // Draws the next arrow from the stack of a vertex
+  void Arrow(int, const Graph&, Workspace&);
+  // Walks from a vertex until the tree or another walk is hit, returns the
+  // number of arrows drawn
+  long long Walk(int, const Graph&, Workspace&);
+};
+
+#endif /* end of include guard: CYCLEPOPPING_H */
@@ -2,35 +2,56 @@
 #include <algorithm>
 #include <iostream>
 
-std::vector<std::pair<int, int>> DepthFirstSearch::SpanningTree(
-    int vertices, const Graph& adjacencylist) {
-  spanningtree.clear();
-  parent = std::vector<int>(vertices, -1);
-  DFS(std::uniform_int_distribution<int>(0, vertices - 1)(generator),
-      adjacencylist);
-  return spanningtree;
+void DepthFirstSearch::SpanningTree(int vertices, const Graph& adjacencylist,
+                                    EdgeSink& sink) {
+  parent.assign(vertices, -1);
+  parentedge.resize(vertices);
+  DFS(RandomIndex(vertices), adjacencylist, &sink);
 }
 
-void DepthFirstSearch::DFS(int vertex, const Graph& adjacencylist) {
-  std::vector<int> nodeorder(adjacencylist[vertex].size());
-  std::iota(nodeorder.begin(), nodeorder.end(), 0);
-  shuffle(nodeorder.begin(), nodeorder.end(), generator);
+void DepthFirstSearch::DFS(int startvertex, const Graph& adjacencylist,
+                           EdgeSink* sink) {
+  // The stack holds the current path only, the next vertex to visit is drawn
+  // among the unvisited neighbors whenever the search returns to a vertex.
+  // This visits neighbors in the same uniformly random order as shuffling
+  // them once per vertex would.
+  neighbors.resize(adjacencylist.MaxDegree());
+  edgeids.resize(adjacencylist.MaxDegree());
+  stack.clear();
+  stack.push_back(startvertex);
+  parent[startvertex] = startvertex;
+
+  while (!stack.empty()) {
+    int vertex = stack.back();
+    int degree =
+        adjacencylist.Neighbors(vertex, neighbors.data(), edgeids.data());
+    int unvisited = 0;
+    for (int i = 0; i < degree; ++i) {
+      if (parent[neighbors[i]] >= 0) continue;
+      neighbors[unvisited] = neighbors[i];
+      edgeids[unvisited++] = edgeids[i];
+    }
+    if (unvisited == 0) {
+      stack.pop_back();
+      continue;
+    }
 
-  for (auto index : nodeorder) {
-    int nextvertex = std::get<0>(adjacencylist[vertex][index]);
-    if (nextvertex < 0 or parent[nextvertex] >= 0) continue;
-    spanningtree.push_back({vertex, nextvertex});
+    int index = 0;
+    if (unvisited > 1) index = RandomIndex(unvisited);
+    int nextvertex = neighbors[index];
+    if (sink) sink->AddEdge(vertex, nextvertex, edgeids[index]);
     parent[nextvertex] = vertex;
-    DFS(nextvertex, adjacencylist);
+    parentedge[nextvertex] = edgeids[index];
+    stack.push_back(nextvertex);
   }
 }
 
-std::vector<int> DepthFirstSearch::Solve(int vertices,
-                                         const Graph& adjacencylist,
-                                         int startvertex) {
-  spanningtree.clear();
-  parent = std::vector<int>(vertices, -1);
-  parent[startvertex] = startvertex;
-  DFS(startvertex, adjacencylist);
-  return parent;
+void DepthFirstSearch::Solve(int vertices, const Graph& adjacencylist,
+                             int start, int end, std::vector<int>& path) {
+  parent.assign(vertices, -1);
+  parentedge.resize(vertices);
+  DFS(start, adjacencylist, nullptr);
+  path.clear();
+  for (int u = end; parent[u] != u; u = parent[u])
+    path.push_back(parentedge[u]);
 }
@@ -6,12 +6,18 @@
 
 class DepthFirstSearch : public SpanningtreeAlgorithm {
  public:
-  std::vector<std::pair<int, int>> SpanningTree(int, const Graph &);
-  std::vector<int> Solve(int, const Graph&, int);
+  void SpanningTree(int, const Graph&, EdgeSink&);
+  // Fills the path with the ids of the edges from the end vertex back to the
+  // start vertex, which the graph has to connect
+  void Solve(int, const Graph&, int start, int end, std::vector<int>& path);
 
  private:
-  std::vector<int> parent;
-  void DFS(int, const Graph &);
+  // Kept between searches, so that searching a graph of the same size again
+  // does not allocate
+  std::vector<int> parent, parentedge, stack, neighbors, edgeids;
+  // Visits the vertices reachable from a vertex without recursing, passing
+  // the tree edges to the sink if there is one
+  void DFS(int, const Graph&, EdgeSink*);
 };
 
 #endif /* end of include guard: DEPTHFIRSTSEARCH_H */
@@ -0,0 +1,101 @@
+#include "eller.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+void Eller::SpanningTree(int, const Graph& graph, EdgeSink& sink) {
+  auto lattice = dynamic_cast<const Lattice*>(&graph);
+  int rows = lattice ? lattice->Rows() : 0;
+  if (!lattice or lattice->Columns(rows - 1) != lattice->Columns(0))
+    throw std::invalid_argument("Eller's algorithm needs a rectangle");
+
+  width_ = lattice->Columns(0);
+  for (auto row : {&sets_, &parent_, &lastcell_, &renumbered_})
+    row->resize(width_);
+  for (auto row : {&right_, &up_, &joined_}) row->resize(width_);
+  std::iota(sets_.begin(), sets_.end(), 0);
+  bitcount_ = 0;
+
+  auto rowsink = dynamic_cast<RowSink*>(&sink);
+  for (int row = 0; row < rows; ++row) {
+    NextRow(row == rows - 1);
+    if (rowsink) {
+      for (int column = 0; column < width_; ++column) {
+        if (right_[column]) rowsink->AddPassage(row, column, false);
+      }
+      for (int column = 0; column < width_; ++column) {
+        if (up_[column]) rowsink->AddPassage(row, column, true);
+      }
+      continue;
+    }
+    for (int column = 0; column < width_; ++column) {
+      int u = lattice->Vertex(row, column);
+      if (right_[column])
+        sink.AddEdge(u, lattice->Vertex(row, column + 1), 4 * u);
+    }
+    for (int column = 0; column < width_; ++column) {
+      int u = lattice->Vertex(row, column);
+      if (up_[column])
+        sink.AddEdge(u, lattice->Vertex(row + 1, column), 4 * u + 1);
+    }
+  }
+}
+
+void Eller::NextRow(bool last) {
+  // Join neighbors in different sets at random, the last row joins all of
+  // them so that the maze ends up connected
+  std::iota(parent_.begin(), parent_.end(), 0);
+  for (int column = 0; column + 1 < width_; ++column) {
+    int left = Find(sets_[column]), right = Find(sets_[column + 1]);
+    right_[column] = left != right and (last or Bit());
+    if (right_[column]) parent_[right] = left;
+  }
+  right_[width_ - 1] = 0;
+  for (auto& set : sets_) set = Find(set);
+
+  if (last) {
+    std::fill(up_.begin(), up_.end(), 0);
+    return;
+  }
+
+  // Open random passages up, and the last cell of every set without one
+  // opens it anyway, so no set is cut off from the rows above
+  for (int column = 0; column < width_; ++column) {
+    lastcell_[sets_[column]] = column;
+    joined_[sets_[column]] = 0;
+  }
+  for (int column = 0; column < width_; ++column) {
+    int set = sets_[column];
+    up_[column] = Bit() or (lastcell_[set] == column and !joined_[set]);
+    if (up_[column]) joined_[set] = 1;
+  }
+
+  // Cells above a passage stay in their set, the others start new ones
+  std::fill(renumbered_.begin(), renumbered_.end(), -1);
+  int sets = 0;
+  for (int column = 0; column < width_; ++column) {
+    if (!up_[column]) continue;
+    int& set = renumbered_[sets_[column]];
+    if (set < 0) set = sets++;
+    sets_[column] = set;
+  }
+  for (int column = 0; column < width_; ++column) {
+    if (!up_[column]) sets_[column] = sets++;
+  }
+}
+
+bool Eller::Bit() {
+  if (bitcount_ == 0) {
+    bits_ = generator();
+    bitcount_ = 64;
+  }
+  --bitcount_;
+  bool bit = bits_ & 1;
+  bits_ >>= 1;
+  return bit;
+}
+
+int Eller::Find(int set) {
+  while (parent_[set] != set) set = parent_[set] = parent_[parent_[set]];
+  return set;
+}
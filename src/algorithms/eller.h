@@ -0,0 +1,38 @@
+#ifndef ELLER_H
+#define ELLER_H
+
+#include "spanningtreealgorithm.h"
+#include <vector>
+
+// Eller's algorithm on a rectangular Lattice, which builds the maze one row
+// at a time and only remembers which cells of the current row are already
+// connected through the rows below. Memory is linear in the width, and the
+// edges come out row by row, so the maze can be written while it is made.
+// A RowSink gets them by row and column, for lattices of any height.
+class Eller : public SpanningtreeAlgorithm {
+ public:
+  void SpanningTree(int, const Graph&, EdgeSink&);
+  bool PassesRows() const { return true; }
+
+ private:
+  int width_;
+  // Set of every cell of the current row, numbered from 0
+  std::vector<int> sets_;
+  // Passages of the current row to the cell on the right and to the cell
+  // in the next row
+  std::vector<char> right_, up_;
+  // Union-find over the sets of the row, and the scratch space used to
+  // connect every set to the next row and to renumber them
+  std::vector<int> parent_, lastcell_, renumbered_;
+  std::vector<char> joined_;
+  // Random bits are drawn 64 at a time
+  uint64_t bits_;
+  int bitcount_;
+
+  // Generates the next row, the last row joins all remaining sets
+  void NextRow(bool last);
+  bool Bit();
+  int Find(int);
+};
+
+#endif /* end of include guard: ELLER_H */
@@ -0,0 +1,74 @@
+#include "graph.h"
+#include <algorithm>
+
+CompressedGraph::CompressedGraph(int vertices,
+                                 const std::vector<std::pair<int, int>>& edges)
+    : vertices_(vertices), edges_(edges.size()), maxdegree_(0) {
+  struct Arrays {
+    std::vector<int> offsets, neighbors, edgeids;
+  };
+  auto arrays = std::make_shared<Arrays>();
+  auto& offsets = arrays->offsets;
+
+  // Counting sort of the half-edges by their source vertex
+  offsets.assign(vertices + 1, 0);
+  for (const auto& edge : edges) {
+    if (edge.second < 0) continue;
+    ++offsets[edge.first + 1];
+    ++offsets[edge.second + 1];
+  }
+  for (int i = 0; i < vertices; ++i) {
+    maxdegree_ = std::max(maxdegree_, offsets[i + 1]);
+    offsets[i + 1] += offsets[i];
+  }
+
+  arrays->neighbors.resize(offsets.back());
+  arrays->edgeids.resize(offsets.back());
+  std::vector<int> position(offsets.begin(), offsets.end() - 1);
+  for (int i = 0; i < int(edges.size()); ++i) {
+    int u = edges[i].first, v = edges[i].second;
+    if (v < 0) continue;
+    arrays->neighbors[position[u]] = v;
+    arrays->edgeids[position[u]++] = i;
+    arrays->neighbors[position[v]] = u;
+    arrays->edgeids[position[v]++] = i;
+  }
+
+  offsets_ = offsets.data();
+  neighbors_ = arrays->neighbors.data();
+  edgeids_ = arrays->edgeids.data();
+  storage_ = std::move(arrays);
+}
+
+CompressedGraph::CompressedGraph(int vertices, int edges, int maxdegree,
+                                 const int* offsets, const int* neighbors,
+                                 const int* edgeids,
+                                 std::shared_ptr<const void> storage)
+    : vertices_(vertices),
+      edges_(edges),
+      maxdegree_(maxdegree),
+      offsets_(offsets),
+      neighbors_(neighbors),
+      edgeids_(edgeids),
+      storage_(std::move(storage)) {}
+
+int CompressedGraph::Neighbors(int vertex, int* neighbors,
+                               int* edgeids) const {
+  int begin = offsets_[vertex], end = offsets_[vertex + 1];
+  std::copy(neighbors_ + begin, neighbors_ + end, neighbors);
+  std::copy(edgeids_ + begin, edgeids_ + end, edgeids);
+  return end - begin;
+}
+
+MaskedGraph::MaskedGraph(const Graph& graph, const Bitset& mask)
+    : graph_(graph), mask_(mask) {}
+
+int MaskedGraph::Neighbors(int vertex, int* neighbors, int* edgeids) const {
+  int degree = graph_.Neighbors(vertex, neighbors, edgeids), kept = 0;
+  for (int i = 0; i < degree; ++i) {
+    if (mask_.Test(edgeids[i])) continue;
+    neighbors[kept] = neighbors[i];
+    edgeids[kept++] = edgeids[i];
+  }
+  return kept;
+}
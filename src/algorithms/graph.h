@@ -0,0 +1,79 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "bitset.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Topology of a maze: vertices are cells, edges are the walls between them.
+// Edges are identified by ids in [0, Edges()), which need not all be used.
+class Graph {
+ public:
+  virtual ~Graph() {}
+  virtual int Vertices() const = 0;
+  virtual int Edges() const = 0;
+  virtual int MaxDegree() const = 0;
+  // Writes the neighbors of a vertex and the ids of the edges leading to
+  // them into buffers of MaxDegree() entries, and returns their number.
+  // Boundary walls are not part of the graph, every neighbor is a vertex.
+  virtual int Neighbors(int, int*, int*) const = 0;
+};
+
+// Cells of a grid laid out in rows, where row r holds the columns
+// [0, Columns(r)) and no row is wider than the one below it. Cells of a row
+// are consecutive vertices, and the edges from a cell to its right and top
+// neighbors have ids 4 * vertex and 4 * vertex + 1. Graphs with this layout
+// can offer it to algorithms which work on the geometry rather than the
+// adjacency.
+class Lattice {
+ public:
+  virtual ~Lattice() {}
+  virtual int Rows() const = 0;
+  virtual int Columns(int) const = 0;
+  virtual int Vertex(int, int) const = 0;
+};
+
+// Compressed sparse row adjacency. The neighbors of a vertex and the ids of
+// the edges leading to them are stored contiguously, so traversals walk flat
+// arrays instead of one heap vector per vertex.
+class CompressedGraph : public Graph {
+ public:
+  // Edge i joins edges[i].first and edges[i].second. An edge to vertex -1 is
+  // a boundary wall, it keeps its id but is left out of the adjacency.
+  CompressedGraph(int, const std::vector<std::pair<int, int>>&);
+  // Graph on arrays kept elsewhere, e.g. in a mapped file, which storage
+  // keeps alive: offsets of the neighbors of every vertex and one past the
+  // last vertex, and the neighbors and edge ids at those offsets
+  CompressedGraph(int vertices, int edges, int maxdegree, const int* offsets,
+                  const int* neighbors, const int* edgeids,
+                  std::shared_ptr<const void> storage);
+
+  int Vertices() const { return vertices_; }
+  int Edges() const { return edges_; }
+  int MaxDegree() const { return maxdegree_; }
+  int Neighbors(int, int*, int*) const;
+
+ private:
+  int vertices_, edges_, maxdegree_;
+  const int *offsets_, *neighbors_, *edgeids_;
+  std::shared_ptr<const void> storage_;
+};
+
+// View of a graph without the edges set in a mask, e.g. the passages of a
+// maze whose standing walls are masked out
+class MaskedGraph : public Graph {
+ public:
+  MaskedGraph(const Graph&, const Bitset&);
+
+  int Vertices() const { return graph_.Vertices(); }
+  int Edges() const { return graph_.Edges(); }
+  int MaxDegree() const { return graph_.MaxDegree(); }
+  int Neighbors(int, int*, int*) const;
+
+ private:
+  const Graph& graph_;
+  const Bitset& mask_;
+};
+
+#endif /* end of include guard: GRAPH_H */
@@ -0,0 +1,120 @@
+#include "growingtree.h"
+#include <algorithm>
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+
+GrowingTree::GrowingTree(Policy policy) : policy_(policy) {
+  // Pick draws below the total, so it has to fit in an int
+  long long total =
+      static_cast<long long>(policy.newest) + policy.oldest + policy.random;
+  if (policy.newest < 0 or policy.oldest < 0 or policy.random < 0 or
+      total <= 0)
+    throw std::invalid_argument(
+        "Policy weights must be non-negative with a positive total");
+  if (total > INT_MAX)
+    throw std::invalid_argument("Policy weights add up to more than " +
+                                std::to_string(INT_MAX));
+}
+
+void GrowingTree::SpanningTree(int vertices, const Graph& adjacencylist,
+                               EdgeSink& sink) {
+  visited_.Assign(vertices, false);
+  neighbors_.resize(adjacencylist.MaxDegree());
+  edgeids_.resize(adjacencylist.MaxDegree());
+  frontier_.clear();
+  frontier_.reserve(vertices);
+  first_ = 0;
+  live_ = 1;
+
+  int start = RandomIndex(vertices);
+  visited_.Set(start);
+  frontier_.push_back(start);
+  while (live_ > 0) {
+    int index = Pick(), vertex = frontier_[index];
+    int degree =
+        adjacencylist.Neighbors(vertex, neighbors_.data(), edgeids_.data());
+    int unvisited = 0;
+    for (int i = 0; i < degree; ++i) {
+      if (visited_.Test(neighbors_[i])) continue;
+      neighbors_[unvisited] = neighbors_[i];
+      edgeids_[unvisited++] = edgeids_[i];
+    }
+    if (unvisited == 0) {
+      Drop(index);
+      continue;
+    }
+
+    int chosen = unvisited > 1 ? RandomIndex(unvisited) : 0;
+    sink.AddEdge(vertex, neighbors_[chosen], edgeids_[chosen]);
+    visited_.Set(neighbors_[chosen]);
+    frontier_.push_back(neighbors_[chosen]);
+    ++live_;
+  }
+}
+
+int GrowingTree::Pick() {
+  // Holes are trimmed at both ends, and squeezed out once they outnumber the
+  // vertices, so that a random slot holds a vertex at least half the time
+  while (frontier_.back() < 0) frontier_.pop_back();
+  while (frontier_[first_] < 0) ++first_;
+  if (2 * live_ < int(frontier_.size()) - first_) {
+    frontier_.erase(
+        std::remove(frontier_.begin() + first_, frontier_.end(), -1),
+        frontier_.end());
+  }
+
+  int weight = policy_.newest + policy_.oldest + policy_.random;
+  int draw = weight == policy_.newest ? 0 : RandomIndex(weight);
+  if (draw < policy_.newest) return frontier_.size() - 1;
+  if (draw < policy_.newest + policy_.oldest) return first_;
+  int size = frontier_.size() - first_, index;
+  do {
+    index = first_ + RandomIndex(size);
+  } while (frontier_[index] < 0);
+  return index;
+}
+
+void GrowingTree::Drop(int index) {
+  // The frontier keeps its order, the hole is skipped by Pick
+  frontier_[index] = -1;
+  --live_;
+}
+
+GrowingTree::Policy GrowingTree::ParsePolicy(const std::string& text) {
+  Policy policy{0, 0, 0};
+  int total = 0;
+  std::istringstream stream(text);
+  for (std::string part; std::getline(stream, part, ',');) {
+    auto colon = part.find(':');
+    std::string name = part.substr(0, colon);
+    int weight = 1;
+    if (colon != std::string::npos) {
+      size_t length = 0;
+      std::string number = part.substr(colon + 1);
+      try {
+        weight = std::stoi(number, &length);
+      } catch (...) {
+        length = 0;
+      }
+      if (length == 0 or length != number.size() or weight < 0)
+        throw std::invalid_argument("Invalid weight in policy " + text);
+    }
+    if (weight > INT_MAX - total)
+      throw std::invalid_argument("Weights of policy " + text +
+                                  " add up to more than " +
+                                  std::to_string(INT_MAX));
+    total += weight;
+    if (name == "newest")
+      policy.newest += weight;
+    else if (name == "oldest")
+      policy.oldest += weight;
+    else if (name == "random")
+      policy.random += weight;
+    else
+      throw std::invalid_argument("Unknown policy " + name);
+  }
+  if (total <= 0)
+    throw std::invalid_argument("Empty policy " + text);
+  return policy;
+}
@@ -0,0 +1,43 @@
+#ifndef GROWINGTREE_H
+#define GROWINGTREE_H
+
+#include "spanningtreealgorithm.h"
+#include <string>
+#include <vector>
+
+// Grows the tree from a random vertex, keeping the vertices of the tree
+// which may still have neighbors outside it in a frontier. Every step picks
+// a frontier vertex by the policy and adds an edge to one of its unvisited
+// neighbors, or drops it once it has none. Always picking the newest vertex
+// gives depth-first mazes, the oldest breadth-first ones and a random one
+// mazes like Prim's algorithm, mixes of them fall in between.
+class GrowingTree : public SpanningtreeAlgorithm {
+ public:
+  // Relative weights of the ways to pick a frontier vertex, non-negative
+  // with a positive total of at most INT_MAX
+  struct Policy {
+    int newest, oldest, random;
+  };
+
+  explicit GrowingTree(Policy = {1, 0, 0});
+  void SpanningTree(int, const Graph&, EdgeSink&);
+
+  // Reads policies like "newest", "random" or "newest:3,random:1", and
+  // throws std::invalid_argument for anything else, including weights
+  // adding up to more than INT_MAX
+  static Policy ParsePolicy(const std::string&);
+
+ private:
+  Policy policy_;
+  Bitset visited_;
+  // Frontier in the order the vertices joined it, in frontier_[first_, end).
+  // Dropped vertices leave a -1 behind, so the order of the others holds.
+  std::vector<int> frontier_;
+  int first_, live_;
+  std::vector<int> neighbors_, edgeids_;
+
+  int Pick();
+  void Drop(int);
+};
+
+#endif /* end of include guard: GROWINGTREE_H */
@@ -1,31 +1,98 @@
 #include "kruskal.h"
+#include "parallel.h"
 #include <algorithm>
-#include <numeric>
-#include <random>
 
-std::vector<std::pair<int, int>> Kruskal::SpanningTree(
-    int vertices, const Graph& adjacencylist) {
-  std::vector<std::pair<int, int>> edges;
-  for (int i = 0; i < vertices; ++i) {
-    for (const auto& edge : adjacencylist[i]) {
-      if (std::get<0>(edge) > i) edges.push_back({i, std::get<0>(edge)});
-    }
+void Kruskal::SpanningTree(int vertices, const Graph& adjacencylist,
+                           EdgeSink& sink) {
+  ShuffleEdges(vertices, adjacencylist);
+
+  parent_.assign(vertices, -1);
+  int treeedges = 0;
+  for (const auto& edge : edges_) {
+    if (treeedges == vertices - 1) break;
+    int u = Find(edge.u), v = Find(edge.v);
+    if (u == v) continue;
+    // Union by size keeps the trees shallow
+    if (parent_[u] > parent_[v]) std::swap(u, v);
+    parent_[u] += parent_[v];
+    parent_[v] = u;
+    sink.AddEdge(edge.u, edge.v, edge.edgeid);
+    ++treeedges;
   }
-  shuffle(edges.begin(), edges.end(), generator);
+}
 
-  parent_ = std::vector<int>(vertices);
-  std::iota(parent_.begin(), parent_.end(), 0);
+void Kruskal::ShuffleEdges(int vertices, const Graph& adjacencylist) {
+  // The edges are scattered into random buckets while they are read from the
+  // graph, and each bucket is then shuffled on its own. Concatenating
+  // uniformly shuffled buckets of multinomial sizes is a uniformly random
+  // permutation. Vertex chunks replay the same bucket draws in the counting
+  // and the scattering pass, so no edge is stored twice. Chunk and bucket
+  // counts are fixed, so the result does not depend on the number of threads.
+  const int chunks = 256, buckets = 256;
+  int chunksize = (vertices + chunks - 1) / chunks;
+  chunkseeds_.resize(chunks);
+  bucketseeds_.resize(buckets);
+  for (auto& seed : chunkseeds_) seed = generator();
+  for (auto& seed : bucketseeds_) seed = generator();
 
-  spanningtree.clear();
-  for (const auto& edge : edges) {
-    int u = GetParent(std::get<0>(edge)), v = GetParent(edge.second);
-    if (u == v) continue;
-    parent_[u] = v;
-    spanningtree.push_back(edge);
+  // counts_[chunk * buckets + bucket] becomes the write position of the
+  // chunk within the bucket
+  counts_.assign(chunks * buckets, 0);
+  auto& buffers = NeighborBuffers(adjacencylist);
+  auto scan = [&](int chunk, bool scatter) {
+    Random chunkgenerator(chunkseeds_[chunk]);
+    // Buckets are single bytes, one output covers eight edges
+    uint64_t bits = 0;
+    int bytes = 0;
+    int* neighbors = buffers[Worker()].neighbors.data();
+    int* edgeids = buffers[Worker()].edgeids.data();
+    long long* position = &counts_[chunk * buckets];
+    int end = std::min(vertices, (chunk + 1) * chunksize);
+    for (int u = chunk * chunksize; u < end; ++u) {
+      int degree = adjacencylist.Neighbors(u, neighbors, edgeids);
+      for (int i = 0; i < degree; ++i) {
+        if (neighbors[i] < u) continue;
+        if (bytes-- == 0) {
+          bits = chunkgenerator();
+          bytes = 7;
+        }
+        int bucket = bits & (buckets - 1);
+        bits >>= 8;
+        if (scatter)
+          edges_[position[bucket]++] = {u, neighbors[i], edgeids[i]};
+        else
+          ++position[bucket];
+      }
+    }
+  };
+
+  ParallelFor(chunks, [&](int chunk) { scan(chunk, false); });
+  bucketbegin_.resize(buckets + 1);
+  long long total = 0;
+  for (int bucket = 0; bucket < buckets; ++bucket) {
+    bucketbegin_[bucket] = total;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+      long long count = counts_[chunk * buckets + bucket];
+      counts_[chunk * buckets + bucket] = total;
+      total += count;
+    }
   }
-  return spanningtree;
+  bucketbegin_[buckets] = total;
+
+  edges_.resize(total);
+  ParallelFor(chunks, [&](int chunk) { scan(chunk, true); });
+  ParallelFor(buckets, [&](int bucket) {
+    Random bucketgenerator(bucketseeds_[bucket]);
+    bucketgenerator.Shuffle(edges_.begin() + bucketbegin_[bucket],
+                            edges_.begin() + bucketbegin_[bucket + 1]);
+  });
 }
 
-int Kruskal::GetParent(int u) {
-  return (parent_[u] == u) ? u : (parent_[u] = GetParent(parent_[u]));
+int Kruskal::Find(int u) {
+  // Path halving, iterative so deep trees cannot overflow the stack
+  while (parent_[u] >= 0) {
+    if (parent_[parent_[u]] >= 0) parent_[u] = parent_[parent_[u]];
+    u = parent_[u];
+  }
+  return u;
 }
@@ -6,12 +6,22 @@
 
 class Kruskal : public SpanningtreeAlgorithm {
  public:
-  std::vector<std::pair<int, int>> SpanningTree(int, const Graph&);
+  void SpanningTree(int, const Graph&, EdgeSink&);
 
  private:
+  struct Edge {
+    int u, v, edgeid;
+  };
+  // Parent of a vertex, or minus the size of the set for a root
   std::vector<int> parent_;
+  // Edges in random order, and the seeds and positions used to shuffle
+  // them, kept so that later trees do not allocate
+  std::vector<Edge> edges_;
+  std::vector<uint64_t> chunkseeds_, bucketseeds_;
+  std::vector<long long> counts_, bucketbegin_;
 
-  int GetParent(int);
+  void ShuffleEdges(int, const Graph&);
+  int Find(int);
 };
 
 #endif /* end of include guard: KRUSKAL_H */
@@ -1,51 +1,45 @@
 #include "looperasedrandomwalk.h"
 #include <algorithm>
 
-std::vector<std::pair<int, int>> LoopErasedRandomWalk::SpanningTree(
-    int vertices, const Graph& adjacencylist) {
-  spanningtree.clear();
-  visited = std::vector<int>(vertices, 0);
+void LoopErasedRandomWalk::SpanningTree(int vertices,
+                                        const Graph& adjacencylist,
+                                        EdgeSink& sink) {
+  intree_.assign(vertices, 0);
+  next_.resize(vertices);
+  nextedge_.resize(vertices);
+  neighbors_.resize(adjacencylist.MaxDegree());
+  edgeids_.resize(adjacencylist.MaxDegree());
 
-  std::vector<int> nodes(vertices);
-  std::iota(nodes.begin(), nodes.end(), 0);
-  shuffle(nodes.begin(), nodes.end(), generator);
-  visited[nodes[0]] = 1;
-  for (int round = 1, i = 1; i < vertices; ++i) {
-    if (visited[nodes[i]]) continue;
-    ++round;
-    LERW(nodes[i], round, adjacencylist);
-  }
-
-  return spanningtree;
+  // Any root gives a uniform tree
+  intree_[RandomIndex(vertices)] = 1;
+  Wilson(vertices, adjacencylist, sink);
 }
 
-void LoopErasedRandomWalk::LERW(int vertex, int round,
-                                const Graph& adjacencylist) {
-  std::vector<int> current;
-
-  while (!visited[vertex]) {
-    visited[vertex] = round;
-    current.push_back(vertex);
-    int nextvertex;
-    do {
-      nextvertex =
-          std::get<0>(adjacencylist[vertex][std::uniform_int_distribution<int>(
-              0, adjacencylist[vertex].size() - 1)(generator)]);
-    } while (nextvertex < 0);
-
-    if (visited[nextvertex] == round) {
-      // Erase the loop
-      do {
-        vertex = current.back();
-        visited[vertex] = 0;
-        current.pop_back();
-      } while (vertex != nextvertex);
+void LoopErasedRandomWalk::Wilson(int vertices, const Graph& adjacencylist,
+                                  EdgeSink& sink) {
+  for (int start = 0; start < vertices; ++start) {
+    // Walk until the tree is hit, remembering only the last exit from every
+    // vertex, which leaves the loop-erased path
+    for (int vertex = start; !intree_[vertex]; vertex = next_[vertex]) {
+      int degree =
+          adjacencylist.Neighbors(vertex, neighbors_.data(), edgeids_.data());
+      if (degree == 0) {
+        // An isolated vertex can only be a tree of its own
+        intree_[vertex] = 1;
+        break;
+      }
+      int index = RandomIndex(degree);
+      next_[vertex] = neighbors_[index];
+      nextedge_[vertex] = edgeids_[index];
     }
 
-    vertex = nextvertex;
-  }
-  current.push_back(vertex);
-  for (unsigned int i = 0; i + 1 < current.size(); ++i) {
-    spanningtree.push_back({current[i], current[i + 1]});
+    path_.clear();
+    for (int vertex = start; !intree_[vertex]; vertex = next_[vertex]) {
+      intree_[vertex] = 1;
+      path_.push_back(vertex);
+    }
+    // Attach the path to the tree starting from the end that reached it
+    for (int i = int(path_.size()) - 1; i >= 0; --i)
+      sink.AddEdge(next_[path_[i]], path_[i], nextedge_[path_[i]]);
   }
 }
@@ -4,13 +4,19 @@
 #include "spanningtreealgorithm.h"
 #include <vector>
 
+// Uniform spanning tree by Wilson's algorithm, every vertex not yet in the
+// tree is attached by a loop-erased random walk until it hits the tree
 class LoopErasedRandomWalk : public SpanningtreeAlgorithm {
  public:
-  std::vector<std::pair<int, int>> SpanningTree(int, const Graph &);
+  void SpanningTree(int, const Graph&, EdgeSink&);
 
  private:
-  std::vector<int> visited;
-  void LERW(int, int, const Graph &);
+  std::vector<char> intree_;
+  // Last step of the walk out of each vertex, overwriting it erases loops
+  std::vector<int> next_, nextedge_;
+  std::vector<int> neighbors_, edgeids_, path_;
+
+  void Wilson(int, const Graph&, EdgeSink&);
 };
 
 #endif /* end of include guard: LOOPERASEDRANDOMWALK_H */
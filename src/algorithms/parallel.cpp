@@ -0,0 +1,113 @@
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+int threads = std::max(1u, std::thread::hardware_concurrency());
+// Set while running a task, nested loops then run serially instead of
+// starting threads of their own
+thread_local bool nested = false;
+thread_local int worker = 0;
+// Held by the thread running a loop on the pool
+std::mutex busy;
+
+// Threads started once and woken for every loop, so that a loop neither
+// starts threads nor allocates. The thread running the loop takes part as
+// worker 0. The pool is restarted when the number of threads changes.
+class Pool {
+ public:
+  ~Pool() { Stop(); }
+
+  void Run(int tasks, const std::function<void(int)>& body) {
+    if (int(workers_.size()) != threads - 1) {
+      Stop();
+      Start(threads - 1);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      body_ = &body;
+      tasks_ = tasks;
+      next_ = 0;
+      running_ = workers_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+    Work(0);
+    nested = false;
+    worker = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&]() { return running_ == 0; });
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_, done_;
+  // The current loop, its generation tells workers that a loop is new
+  const std::function<void(int)>* body_ = nullptr;
+  int tasks_ = 0, running_ = 0;
+  std::atomic<int> next_{0};
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+
+  void Work(int id) {
+    nested = true;
+    worker = id;
+    for (int task; (task = next_++) < tasks_;) (*body_)(task);
+  }
+
+  void Loop(int id, uint64_t generation) {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock,
+                   [&]() { return stop_ or generation_ != generation; });
+        if (stop_) return;
+        generation = generation_;
+      }
+      Work(id);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--running_ == 0) done_.notify_one();
+    }
+  }
+
+  void Start(int count) {
+    stop_ = false;
+    for (int id = 1; id <= count; ++id)
+      workers_.emplace_back(&Pool::Loop, this, id, generation_);
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : workers_) thread.join();
+    workers_.clear();
+  }
+};
+}  // namespace
+
+int Threads() { return threads; }
+
+void SetThreads(int count) { threads = std::max(1, count); }
+
+int Worker() { return worker; }
+
+void ParallelFor(int tasks, const std::function<void(int)>& body) {
+  int workers = nested ? 1 : std::min(threads, tasks);
+  // Loops started while another thread runs a loop on the pool run serially
+  std::unique_lock<std::mutex> lock(busy, std::defer_lock);
+  if (workers <= 1 or !lock.try_lock()) {
+    for (int task = 0; task < tasks; ++task) body(task);
+    return;
+  }
+  static Pool pool;
+  pool.Run(tasks, body);
+}
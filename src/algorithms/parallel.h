@@ -0,0 +1,71 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Number of worker threads used by the parallel algorithms, defaults to the
+// number of hardware threads
+int Threads();
+void SetThreads(int);
+
+// Runs body(task) for every task in [0, tasks) on up to Threads() threads.
+// Tasks are handed out dynamically, so they should be independent and
+// reasonably coarse. Loops started from a task run serially. The threads
+// are started by the first loop and wait for the following ones, so loops
+// are cheap enough to run once per round of an algorithm.
+void ParallelFor(int tasks, const std::function<void(int)>& body);
+
+// Passes the body on by reference, so that lambdas with many captures do
+// not allocate a copy of themselves for every loop
+template <typename Body>
+void ParallelFor(int tasks, const Body& body) {
+  ParallelFor(tasks, std::function<void(int)>(std::cref(body)));
+}
+
+// Index in [0, Threads()) of the thread running the current task, so that
+// tasks can share scratch space per thread. It is 0 outside of loops.
+int Worker();
+
+// Queue between threads holding at most a fixed number of items, so that
+// producers wait for consumers instead of piling up work. Pop waits for an
+// item and returns false once the queue is closed and empty.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(int capacity) : capacity_(capacity), closed_(false) {}
+
+  void Push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notfull_.wait(lock, [&]() { return int(items_.size()) < capacity_; });
+    items_.push_back(std::move(item));
+    notempty_.notify_one();
+  }
+
+  bool Pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notempty_.wait(lock, [&]() { return closed_ or !items_.empty(); });
+    if (items_.empty()) return false;
+    item = std::move(items_.front());
+    items_.pop_front();
+    notfull_.notify_one();
+    return true;
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    notempty_.notify_all();
+  }
+
+ private:
+  int capacity_;
+  bool closed_;
+  std::deque<T> items_;
+  std::mutex mutex_;
+  std::condition_variable notfull_, notempty_;
+};
+
+#endif /* end of include guard: PARALLEL_H */
@@ -1,36 +1,69 @@
 #include "prim.h"
-#include <algorithm>
 
-std::vector<std::pair<int, int>> Prim::SpanningTree(
-    int vertices, const Graph& adjacencylist) {
-  spanningtree.clear();
-
-  PrimAlgorithm(vertices, adjacencylist);
-  return spanningtree;
+void Prim::SpanningTree(int vertices, const Graph& adjacencylist,
+                        EdgeSink& sink) {
+  frontier_.resize(adjacencylist.MaxDegree() + 1);
+  for (auto& group : frontier_) group.clear();
+  frontieredges_ = 0;
+  count_.assign(vertices, 0);
+  position_.resize(vertices);
+  neighbors_.resize(adjacencylist.MaxDegree());
+  edgeids_.resize(adjacencylist.MaxDegree());
+  if (vertices > 0) PrimAlgorithm(vertices, adjacencylist, sink);
 }
 
-void Prim::PrimAlgorithm(int vertices, const Graph& adjacencylist) {
-  std::vector<bool> visited(vertices, false);
-  std::vector<std::pair<int, int>> boundary;
-  int vertex = std::uniform_int_distribution<int>(0, vertices - 1)(generator);
+void Prim::PrimAlgorithm(int vertices, const Graph& adjacencylist,
+                         EdgeSink& sink) {
+  int vertex = RandomIndex(vertices);
+  Visit(vertex,
+        adjacencylist.Neighbors(vertex, neighbors_.data(), edgeids_.data()));
 
-  for (int i = 1; i < vertices; ++i) {
-    visited[vertex] = true;
-    for (auto p : adjacencylist[vertex]) {
-      if (std::get<0>(p) != -1 and !visited[std::get<0>(p)])
-        boundary.push_back({vertex, std::get<0>(p)});
-    }
+  while (frontieredges_ > 0) {
+    // Pick one of the edges leaving the tree, a vertex with count edges into
+    // the tree covers count consecutive edges of its group
+    int edge = RandomIndex(frontieredges_);
+    int count = 1;
+    for (; edge >= count * int(frontier_[count].size()); ++count)
+      edge -= count * frontier_[count].size();
+    vertex = frontier_[count][edge / count];
+    int k = edge % count;
 
-    std::pair<int, int> nextedge = {-1, -1};
-    do {
-      int index =
-          std::uniform_int_distribution<int>(0, boundary.size() - 1)(generator);
-      std::swap(boundary[index], boundary.back());
-      if (!visited[boundary.back().second]) nextedge = boundary.back();
-      boundary.pop_back();
-    } while (nextedge.first == -1);
+    int degree =
+        adjacencylist.Neighbors(vertex, neighbors_.data(), edgeids_.data());
+    for (int i = 0; i < degree; ++i) {
+      if (count_[neighbors_[i]] < 0 and k-- == 0) {
+        sink.AddEdge(neighbors_[i], vertex, edgeids_[i]);
+        break;
+      }
+    }
+    Visit(vertex, degree);
+  }
+}
 
-    spanningtree.push_back(nextedge);
-    vertex = nextedge.second;
+// Moves a vertex into the tree, its neighbors are in neighbors_
+void Prim::Visit(int vertex, int degree) {
+  if (count_[vertex] > 0) Remove(vertex);
+  frontieredges_ -= count_[vertex];
+  count_[vertex] = -1;
+  for (int i = 0; i < degree; ++i) {
+    int neighbor = neighbors_[i];
+    if (count_[neighbor] < 0) continue;
+    if (count_[neighbor] > 0) Remove(neighbor);
+    Insert(neighbor, count_[neighbor] + 1);
+    ++frontieredges_;
   }
 }
+
+void Prim::Insert(int vertex, int count) {
+  count_[vertex] = count;
+  position_[vertex] = frontier_[count].size();
+  frontier_[count].push_back(vertex);
+}
+
+void Prim::Remove(int vertex) {
+  auto& group = frontier_[count_[vertex]];
+  int last = group.back();
+  group[position_[vertex]] = last;
+  position_[last] = position_[vertex];
+  group.pop_back();
+}
@@ -4,12 +4,27 @@
 #include "spanningtreealgorithm.h"
 #include <vector>
 
+// Grows the tree from a random vertex, adding a uniformly chosen edge from
+// the tree to a vertex outside it at every step
 class Prim : public SpanningtreeAlgorithm {
  public:
-  std::vector<std::pair<int, int>> SpanningTree(int, const Graph &);
+  void SpanningTree(int, const Graph&, EdgeSink&);
 
  private:
-  void PrimAlgorithm(int, const Graph &);
+  // Vertices next to the tree, each exactly once, grouped by the number of
+  // edges they have into the tree
+  std::vector<std::vector<int>> frontier_;
+  // Number of edges between the tree and the rest of the graph
+  int frontieredges_;
+  // Edges into the tree and index in the frontier group of every vertex,
+  // the count is -1 for vertices in the tree
+  std::vector<int> count_, position_;
+  std::vector<int> neighbors_, edgeids_;
+
+  void PrimAlgorithm(int, const Graph&, EdgeSink&);
+  void Visit(int, int);
+  void Insert(int, int);
+  void Remove(int);
 };
 
 #endif /* end of include guard: PRIM_H */
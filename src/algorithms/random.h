@@ -0,0 +1,86 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+// xoshiro256** generator, small and fast enough to keep in inner loops. It
+// meets the requirements of a uniform random bit generator, so it also works
+// with the standard distributions.
+class Random {
+ public:
+  using result_type = uint64_t;
+
+  explicit Random(uint64_t seed = 0) { Seed(seed); }
+
+  // Expands the seed with splitmix64, which never leaves the state all zero
+  void Seed(uint64_t seed) {
+    for (auto& word : state_) word = Mix(seed += 0x9e3779b97f4a7c15ull);
+  }
+
+  // Finaliser of splitmix64, a bijection which scrambles every bit
+  static uint64_t Mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  // Fills words with random bits hashed from consecutive counters. There is
+  // no state carried between words, so compilers can vectorise the loop.
+  static void Fill(uint64_t counter, uint64_t* words, int count) {
+    for (int i = 0; i < count; ++i)
+      words[i] = Mix((counter + i) * 0x9e3779b97f4a7c15ull);
+  }
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() { return ~uint64_t(0); }
+
+  uint64_t operator()() {
+    uint64_t result = Rotate(state_[1] * 5, 7) * 9;
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotate(state_[3], 45);
+    return result;
+  }
+
+  // Uniform integer in [0, n) for 0 < n < 2^32
+  uint32_t Bounded(uint32_t n) { return Bounded(n, (*this)() >> 32); }
+
+  // Fisher-Yates shuffle, every output feeds two bounded draws
+  template <typename Iterator>
+  void Shuffle(Iterator first, Iterator last) {
+    uint32_t i = std::distance(first, last);
+    for (; i > 2; i -= 2) {
+      uint64_t bits = (*this)();
+      std::iter_swap(first + (i - 1), first + Bounded(i, bits >> 32));
+      std::iter_swap(first + (i - 2), first + Bounded(i - 1, uint32_t(bits)));
+    }
+    if (i == 2) std::iter_swap(first + 1, first + Bounded(2));
+  }
+
+ private:
+  uint64_t state_[4];
+
+  static uint64_t Rotate(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  // Lemire's multiply and shift on the given bits. The rejection step needs
+  // a division but is only reached when the low half is below n.
+  uint32_t Bounded(uint32_t n, uint32_t bits) {
+    uint64_t product = uint64_t(bits) * n;
+    if (uint32_t(product) < n) {
+      uint32_t threshold = -n % n;
+      while (uint32_t(product) < threshold)
+        product = uint64_t((*this)() >> 32) * n;
+    }
+    return product >> 32;
+  }
+};
+
+#endif /* end of include guard: RANDOM_H */
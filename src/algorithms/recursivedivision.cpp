@@ -0,0 +1,106 @@
+#include "recursivedivision.h"
+#include <algorithm>
+#include <stdexcept>
+
+void RecursiveDivision::SpanningTree(int, const Graph& graph, EdgeSink& sink) {
+  lattice_ = dynamic_cast<const Lattice*>(&graph);
+  if (!lattice_)
+    throw std::invalid_argument("Recursive division needs a lattice");
+
+  // Divide serially until regions are small enough to be independent tasks
+  const int leafcells = 1 << 14;
+  leaves_.clear();
+  stack_.assign(1, Clip({0, lattice_->Rows(), 0, lattice_->Columns(0)}));
+  while (!stack_.empty()) {
+    Region region = stack_.back();
+    stack_.pop_back();
+    if (region.endrow == region.row) continue;
+    long long cells = (long long)(region.endrow - region.row) *
+                      (region.endcolumn - region.column);
+    if (cells <= leafcells) {
+      leaves_.push_back(region);
+      continue;
+    }
+    Divide(region, generator, stack_, [&](int u, int v, int edgeid) {
+      sink.AddEdge(u, v, edgeid);
+    });
+  }
+
+  // Leaves are divided in parallel, each with a seed of its own
+  uint64_t seed = generator();
+  if (int(regions_.size()) < EdgeSlots()) regions_.resize(EdgeSlots());
+  ParallelEdges(leaves_.size(), [&](int leaf, EdgeSink& leafsink) {
+    Random random(seed + leaf);
+    auto& regions = regions_[leaf % EdgeSlots()];
+    regions.assign(1, leaves_[leaf]);
+    while (!regions.empty()) {
+      Region region = regions.back();
+      regions.pop_back();
+      Divide(region, random, regions, [&](int u, int v, int edgeid) {
+        leafsink.AddEdge(u, v, edgeid);
+      });
+    }
+  }, sink);
+}
+
+RecursiveDivision::Region RecursiveDivision::Clip(Region region) const {
+  // Rows only get narrower, so the bottom row bounds the columns and the
+  // rows reaching the first column are contiguous
+  region.endcolumn = std::min(region.endcolumn, lattice_->Columns(region.row));
+  if (region.endcolumn <= region.column) return {0, 0, 0, 0};
+  int low = region.row + 1, high = region.endrow;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    if (lattice_->Columns(middle) > region.column)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  region.endrow = low;
+  return region;
+}
+
+template <typename Sink>
+void RecursiveDivision::Divide(const Region& region, Random& random,
+                               std::vector<Region>& regions, Sink sink) const {
+  int rows = region.endrow - region.row,
+      columns = region.endcolumn - region.column;
+  auto right = [&](int row, int column) {
+    int u = lattice_->Vertex(row, column);
+    sink(u, lattice_->Vertex(row, column + 1), 4 * u);
+  };
+  auto up = [&](int row, int column) {
+    int u = lattice_->Vertex(row, column);
+    sink(u, lattice_->Vertex(row + 1, column), 4 * u + 1);
+  };
+
+  if (columns == 1 or rows == 1) {
+    for (int row = region.row; row + 1 < region.endrow; ++row)
+      up(row, region.column);
+    for (int column = region.column; column + 1 < region.endcolumn; ++column)
+      right(region.row, column);
+    return;
+  }
+
+  // Split across the longer side, so regions stay close to square
+  bool vertical =
+      columns > rows or (columns == rows and (random() >> 63) != 0);
+  if (vertical) {
+    int column = region.column + 1 + random.Bounded(columns - 1);
+    Region left = region, other = region;
+    left.endcolumn = other.column = column;
+    // The gap goes in one of the rows which reach across the wall
+    other = Clip(other);
+    right(region.row + random.Bounded(other.endrow - other.row), column - 1);
+    regions.push_back(left);
+    regions.push_back(other);
+  } else {
+    int row = region.row + 1 + random.Bounded(rows - 1);
+    Region below = region, above = region;
+    below.endrow = above.row = row;
+    above = Clip(above);
+    up(row - 1, region.column + random.Bounded(above.endcolumn - above.column));
+    regions.push_back(below);
+    regions.push_back(above);
+  }
+}
@@ -0,0 +1,36 @@
+#ifndef RECURSIVEDIVISION_H
+#define RECURSIVEDIVISION_H
+
+#include "spanningtreealgorithm.h"
+#include <vector>
+
+// Recursive division of a Lattice: a region is split in two by a wall with
+// a single gap, and both halves are divided again until they are one cell
+// wide. Apart from the regions still to divide it needs no memory at all.
+// Regions below a fixed size are divided in parallel, each with its own
+// seed, so the maze does not depend on the number of threads.
+class RecursiveDivision : public SpanningtreeAlgorithm {
+ public:
+  void SpanningTree(int, const Graph&, EdgeSink&);
+
+ private:
+  // Cells in rows [row, endrow) and columns [column, endcolumn)
+  struct Region {
+    int row, endrow, column, endcolumn;
+  };
+
+  const Lattice* lattice_;
+  // Regions still to divide, serially and in every slot of ParallelEdges,
+  // and the regions divided in parallel. They are kept between trees.
+  std::vector<Region> stack_, leaves_;
+  std::vector<std::vector<Region>> regions_;
+
+  // Shrinks a region to the cells of the lattice
+  Region Clip(Region) const;
+  // Splits a region and passes the gap to the sink, or passes all the edges
+  // of a region one cell wide or high
+  template <typename Sink>
+  void Divide(const Region&, Random&, std::vector<Region>&, Sink) const;
+};
+
+#endif /* end of include guard: RECURSIVEDIVISION_H */
@@ -0,0 +1,48 @@
+#include "rowalgorithm.h"
+#include "parallel.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+void RowAlgorithm::SpanningTree(int, const Graph& graph, EdgeSink& sink) {
+  auto lattice = dynamic_cast<const Lattice*>(&graph);
+  if (!lattice) throw std::invalid_argument("Row algorithms need a lattice");
+
+  // Rows are grouped into chunks of about the same number of cells
+  int rows = lattice->Rows(), width = lattice->Columns(0),
+      words = (width + 63) / 64;
+  int chunkrows = std::max(1, (1 << 14) / width),
+      chunks = (rows + chunkrows - 1) / chunkrows;
+  uint64_t key = generator(), counter = generator();
+  if (int(buffers_.size()) < Threads()) buffers_.resize(Threads());
+  for (auto& buffer : buffers_) {
+    buffer.bits.resize(words);
+    buffer.left.resize(width);
+    buffer.down.resize(width);
+  }
+  ParallelEdges(chunks, [&](int chunk, EdgeSink& chunksink) {
+    auto& bits = buffers_[Worker()].bits;
+    auto& left = buffers_[Worker()].left;
+    auto& down = buffers_[Worker()].down;
+    int end = std::min(rows, (chunk + 1) * chunkrows);
+    for (int row = chunk * chunkrows; row < end; ++row) {
+      int columns = lattice->Columns(row);
+      Random random(key + row);
+      Random::Fill(counter + uint64_t(row) * words, bits.data(), words);
+      std::fill(left.begin(), left.end(), 0);
+      std::fill(down.begin(), down.end(), 0);
+      CarveRow(row, columns, bits.data(), random, left.data(), down.data());
+
+      int first = lattice->Vertex(row, 0),
+          below = row > 0 ? lattice->Vertex(row - 1, 0) : 0;
+      for (int column = 0; column < columns; ++column) {
+        int v = first + column;
+        if (left[column]) chunksink.AddEdge(v - 1, v, 4 * (v - 1));
+        if (down[column]) {
+          int u = below + column;
+          chunksink.AddEdge(u, v, 4 * u + 1);
+        }
+      }
+    }
+  }, sink);
+}
@@ -0,0 +1,32 @@
+#ifndef ROWALGORITHM_H
+#define ROWALGORITHM_H
+
+#include "spanningtreealgorithm.h"
+#include <vector>
+
+// Algorithms on a Lattice which carve every row on its own, joining each
+// cell to the cell on its left or below it. Rows are carved in parallel,
+// each with random bits hashed from its own counters, and passed on in
+// order, so mazes only depend on the seed and can be written row by row.
+// Memory is linear in the width, for each thread.
+class RowAlgorithm : public SpanningtreeAlgorithm {
+ public:
+  void SpanningTree(int, const Graph&, EdgeSink&);
+
+ protected:
+  // Sets left[c] to open the wall on the left of cell c of the row and
+  // down[c] to open the wall below it. There is a random bit per column in
+  // bits, and a generator of the row for anything else.
+  virtual void CarveRow(int row, int columns, const uint64_t* bits,
+                        Random& random, char* left, char* down) const = 0;
+
+ private:
+  // Row buffers of every thread, kept between trees
+  struct RowBuffer {
+    std::vector<uint64_t> bits;
+    std::vector<char> left, down;
+  };
+  std::vector<RowBuffer> buffers_;
+};
+
+#endif /* end of include guard: ROWALGORITHM_H */
@@ -0,0 +1,19 @@
+#include "sidewinder.h"
+
+void Sidewinder::CarveRow(int row, int columns, const uint64_t* bits,
+                          Random& random, char* left, char* down) const {
+  // The first row is a single run without a row below
+  if (row == 0) {
+    for (int column = 1; column < columns; ++column) left[column] = 1;
+    return;
+  }
+  for (int start = 0, column = 0; column < columns; ++column) {
+    bool bit = (bits[column >> 6] >> (column & 63)) & 1;
+    if (column + 1 < columns and bit) {
+      left[column + 1] = 1;
+    } else {
+      down[start + random.Bounded(column - start + 1)] = 1;
+      start = column + 1;
+    }
+  }
+}
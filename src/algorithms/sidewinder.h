@@ -0,0 +1,13 @@
+#ifndef SIDEWINDER_H
+#define SIDEWINDER_H
+
+#include "rowalgorithm.h"
+
+// Cells are joined into runs along each row by coin flips, and every run
+// opens a single passage down from a random cell
+class Sidewinder : public RowAlgorithm {
+ protected:
+  void CarveRow(int, int, const uint64_t*, Random&, char*, char*) const;
+};
+
+#endif /* end of include guard: SIDEWINDER_H */
@@ -1,5 +1,58 @@
 #include "spanningtreealgorithm.h"
+#include "parallel.h"
+#include <algorithm>
+#include <random>
 
 SpanningtreeAlgorithm::SpanningtreeAlgorithm() {
-  generator = std::mt19937(randomdevice());
+  std::random_device randomdevice;
+  Seed(uint64_t(randomdevice()) << 32 | randomdevice());
+}
+
+std::vector<int> SpanningtreeAlgorithm::SpanningTreeEdges(
+    int vertices, const Graph& graph) {
+  class EdgeList : public EdgeSink {
+   public:
+    std::vector<int> edgeids;
+    void AddEdge(int, int, int edgeid) { edgeids.push_back(edgeid); }
+  } edgelist;
+  edgelist.edgeids.reserve(vertices - 1);
+  SpanningTree(vertices, graph, edgelist);
+  return edgelist.edgeids;
+}
+
+std::vector<SpanningtreeAlgorithm::NeighborBuffer>&
+SpanningtreeAlgorithm::NeighborBuffers(const Graph& graph) {
+  if (int(neighborbuffers_.size()) < Threads())
+    neighborbuffers_.resize(Threads());
+  for (auto& buffer : neighborbuffers_) {
+    buffer.neighbors.resize(graph.MaxDegree());
+    buffer.edgeids.resize(graph.MaxDegree());
+  }
+  return neighborbuffers_;
+}
+
+int SpanningtreeAlgorithm::EdgeSlots() { return 4 * Threads(); }
+
+void SpanningtreeAlgorithm::ParallelEdges(
+    int tasks, const std::function<void(int, EdgeSink&)>& task,
+    EdgeSink& sink) {
+  // A single thread can pass the edges on directly
+  if (Threads() == 1) {
+    for (int i = 0; i < tasks; ++i) task(i, sink);
+    return;
+  }
+
+  int batch = EdgeSlots();
+  if (int(edgebuffers_.size()) < batch) edgebuffers_.resize(batch);
+  for (int first = 0; first < tasks; first += batch) {
+    int count = std::min(batch, tasks - first);
+    ParallelFor(count, [&](int i) {
+      edgebuffers_[i].edges.clear();
+      task(first + i, edgebuffers_[i]);
+    });
+    for (int i = 0; i < count; ++i) {
+      for (const auto& edge : edgebuffers_[i].edges)
+        sink.AddEdge(edge.u, edge.v, edge.edgeid);
+    }
+  }
 }
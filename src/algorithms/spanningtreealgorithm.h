@@ -1,23 +1,87 @@
 #ifndef SPANNINGTREEALGORITHM_H
 #define SPANNINGTREEALGORITHM_H
 
-#include "cellborder.h"
-#include <memory>
-#include <random>
+#include "graph.h"
+#include "random.h"
+#include <cstdint>
+#include <functional>
 #include <vector>
 
-typedef std::tuple<int, std::shared_ptr<CellBorder>> Edge;
-typedef std::vector<std::vector<Edge>> Graph;
+// Receives the edges of a spanning tree while an algorithm carves them, as
+// the two vertices joined and the edge id. Algorithms growing a single tree
+// pass the vertex already in the tree first.
+class EdgeSink {
+ public:
+  virtual ~EdgeSink() {}
+  virtual void AddEdge(int, int, int) = 0;
+};
+
+// Sink of the passages of a rectangular Lattice, by the row and column of
+// the cell they leave to the right or up. Algorithms which pass rows this
+// way never number the cells, so the lattice may have more of them than
+// int vertex and edge ids can reach.
+class RowSink : public EdgeSink {
+ public:
+  virtual void AddPassage(int row, int column, bool up) = 0;
+};
 
 class SpanningtreeAlgorithm {
  public:
   SpanningtreeAlgorithm();
-  virtual std::vector<std::pair<int, int>> SpanningTree(int, const Graph&) = 0;
+  // Passes the edges of a random spanning tree of the graph to the sink
+  virtual void SpanningTree(int, const Graph&, EdgeSink&) = 0;
+  // Returns the ids of the edges of a random spanning tree of the graph.
+  // Named apart from SpanningTree, which subclasses override and would hide.
+  std::vector<int> SpanningTreeEdges(int, const Graph&);
+  // Whether the algorithm passes the edges of a lattice to a RowSink by row
+  // and column, ignoring the vertex count
+  virtual bool PassesRows() const { return false; }
+  // Makes the following trees reproducible, they are seeded from
+  // std::random_device otherwise
+  void Seed(uint64_t seed) { generator.Seed(seed); }
 
  protected:
-  std::vector<std::pair<int, int>> spanningtree;
-  std::random_device randomdevice;
-  std::mt19937 generator;
+  Random generator;
+
+  // Uniform integer in [0, n)
+  int RandomIndex(int n) { return generator.Bounded(n); }
+  // Runs task(i, sink) for every i in [0, tasks) in parallel, and passes the
+  // edges of each task on to the sink in task order. Tasks run in batches
+  // of EdgeSlots(), so only the edges of a few tasks per thread are held at
+  // once. Task i runs in slot i % EdgeSlots(), which no other running task
+  // shares, so scratch space kept per slot is used by the same tasks every
+  // time and does not grow again for another maze of the same size.
+  void ParallelEdges(int, const std::function<void(int, EdgeSink&)>&,
+                     EdgeSink&);
+  template <typename Task>
+  void ParallelEdges(int tasks, const Task& task, EdgeSink& sink) {
+    ParallelEdges(
+        tasks, std::function<void(int, EdgeSink&)>(std::cref(task)), sink);
+  }
+
+  // Buffers for the neighbors and edge ids of a vertex
+  struct NeighborBuffer {
+    std::vector<int> neighbors, edgeids;
+  };
+  // A buffer for every worker thread sized for the graph, to be indexed with
+  // Worker(). They are kept between trees, so that generating another maze
+  // of the same size does not allocate.
+  std::vector<NeighborBuffer>& NeighborBuffers(const Graph&);
+  static int EdgeSlots();
+
+ private:
+  // Edges of a task of ParallelEdges, kept between trees
+  class EdgeBuffer : public EdgeSink {
+   public:
+    struct Edge {
+      int u, v, edgeid;
+    };
+    std::vector<Edge> edges;
+    void AddEdge(int u, int v, int edgeid) { edges.push_back({u, v, edgeid}); }
+  };
+
+  std::vector<NeighborBuffer> neighborbuffers_;
+  std::vector<EdgeBuffer> edgebuffers_;
 };
 
 #endif /* end of include guard: SPANNINGTREEALGORITHM_H */
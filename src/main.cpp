@@ -1,26 +1,46 @@
+#include "binarytree.h"
+#include "boruvka.h"
 #include "breadthfirstsearch.h"
 #include "circularhexagonmaze.h"
 #include "circularmaze.h"
+#include "cyclepopping.h"
 #include "depthfirstsearch.h"
+#include "eller.h"
+#include "growingtree.h"
 #include "hexagonalmaze.h"
 #include "honeycombmaze.h"
 #include "kruskal.h"
 #include "looperasedrandomwalk.h"
+#include "parallel.h"
 #include "prim.h"
+#include "recursivedivision.h"
 #include "rectangularmaze.h"
+#include "sidewinder.h"
+#include "streamedmaze.h"
 #include "triangularmaze.h"
 #include "usermaze.h"
-#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 void usage(std::ostream &out) {
   out << "Usage: mazegen [--help] [-m <maze type>] [-a <algorithm type>]"
       << std::endl;
   out << "               [-s <size> | -w <width> -h <height>]" << std::endl;
-  out << "               [-t <output type>] [-o <output prefix>]" << std::endl;
+  out << "               [-t <output type>] [-o <output prefix>]"
+      << " [-d <decimals>]" << std::endl;
   out << "               [-f <graph description file (for m=5)>]" << std::endl;
+  out << "               [-r <seed>] [-p <tile size>]" << std::endl;
+  out << "               [-g <growing tree policy (for a=11)>]" << std::endl;
+  out << "               [-n <count>] [-j <job file>]" << std::endl;
+  out << "               [-c <cache directory (for m=5)>]" << std::endl;
 
   out << std::endl;
   out << "Optional arguments" << std::endl;
@@ -54,6 +74,23 @@ void usage(std::ostream &out) {
       << "3: Loop-erased random walk" << std::endl;
   out << "          "
       << "4: Prim's algorithm" << std::endl;
+  out << "          "
+      << "5: Parallel Boruvka's algorithm" << std::endl;
+  out << "          "
+      << "6: Parallel cycle popping (uniform like 3)" << std::endl;
+  out << "          "
+      << "7: Eller's algorithm (rectangular only, streamed)" << std::endl;
+  out << "          "
+      << "8: Parallel recursive division (rectangular and triangular only)"
+      << std::endl;
+  out << "          "
+      << "9: Parallel binary tree (rectangular and triangular only)"
+      << std::endl;
+  out << "          "
+      << "10: Parallel sidewinder (rectangular and triangular only)"
+      << std::endl;
+  out << "          "
+      << "11: Growing tree, picking vertices by the -g policy" << std::endl;
   out << "  -s      "
       << "Size (non-rectangular mazes, default: 20)" << std::endl;
   out << "  -w,-h   "
@@ -66,202 +103,605 @@ void usage(std::ostream &out) {
       << "1: png output using gnuplot (.plt) intermediate " << std::endl;
   out << "  -o      "
       << "Prefix for .svg, .plt and .png outputs (default: maze)" << std::endl;
+  out << "  -d      "
+      << "Decimals of the output coordinates, integral ones have none"
+      << std::endl;
+  out << "          "
+      << "(0 to 17, default: 6)" << std::endl;
+  out << "  -r      "
+      << "Random seed, the same seed gives the same maze (default: random)"
+      << std::endl;
+  out << "  -p      "
+      << "Carve a rectangular maze as tiles of this size in parallel, joined"
+      << std::endl;
+  out << "          "
+      << "by one passage per seam of a random tree (default: 0, no tiles)"
+      << std::endl;
+  out << "  -g      "
+      << "Weights of picking the newest, oldest or a random vertex, as in"
+      << std::endl;
+  out << "          "
+      << "newest:3,random:1 (default: newest)" << std::endl;
+  out << "  -n      "
+      << "Number of mazes, written to <prefix>-0, <prefix>-1, ... (default: 1)"
+      << std::endl;
+  out << "  -j      "
+      << "File with the arguments of one batch of mazes per line, the other"
+      << std::endl;
+  out << "          "
+      << "arguments apply to every line" << std::endl;
+  out << "  -c      "
+      << "Directory keeping the graphs read with -f, later runs on the same"
+      << std::endl;
+  out << "          "
+      << "file map them instead of reading the file again" << std::endl;
 }
 
-int main(int argc, char *argv[]) {
-  std::string outputprefix = "maze", infile = "";
-  std::map<std::string, int> optionmap{{"-m", 0},  {"-a", 0},     {"-s", 20},
-                                       {"-w", 20}, {"-h", 20},    {"-o", 0},
-                                       {"-f", 0},  {"--help", 0}, {"-t", 0}};
-
-  for (int i = 1; i < argc; i++) {
-    if (optionmap.find(argv[i]) == optionmap.end()) {
-      std::cerr << "Unknown argument " << argv[i] << "\n";
-      usage(std::cerr);
-      return 1;
+// Spanning tree algorithm of the given -a option, and the policy of the
+// growing tree algorithm
+SpanningtreeAlgorithm *NewAlgorithm(int type,
+                                    const GrowingTree::Policy &policy) {
+  switch (type) {
+    case 0:
+      return new Kruskal;
+    case 1:
+      return new DepthFirstSearch;
+    case 2:
+      return new BreadthFirstSearch;
+    case 3:
+      return new LoopErasedRandomWalk;
+    case 4:
+      return new Prim;
+    case 5:
+      return new Boruvka;
+    case 6:
+      return new CyclePopping;
+    case 7:
+      return new Eller;
+    case 8:
+      return new RecursiveDivision;
+    case 9:
+      return new BinaryTree;
+    case 10:
+      return new Sidewinder;
+    case 11:
+      return new GrowingTree(policy);
+  }
+  return nullptr;
+}
+
+// Options of a single maze, or of every maze of a batch job
+struct Options {
+  std::string outputprefix = "maze", infile = "", jobfile = "",
+              cachedirectory = "";
+  std::map<std::string, int> optionmap{
+      {"-m", 0},  {"-a", 0}, {"-s", 20}, {"-w", 20}, {"-h", 20},
+      {"-o", 0},  {"-f", 0}, {"-t", 0},  {"-r", 0},  {"-p", 0},
+      {"-g", 0},  {"-n", 1}, {"-j", 0},  {"-c", 0},  {"-d", 6},
+      {"--help", 0}};
+  bool seeded = false, help = false;
+  uint64_t seed = 0;
+  std::string policytext = "newest";
+  GrowingTree::Policy policy = GrowingTree::ParsePolicy(policytext);
+};
+
+// Reads arguments into the options, prints the error and returns false for
+// invalid ones
+bool ParseArguments(const std::vector<std::string> &arguments,
+                    Options &options) {
+  auto &optionmap = options.optionmap;
+  int argc = arguments.size();
+  for (int i = 0; i < argc; i++) {
+    const std::string &argument = arguments[i];
+    if (optionmap.find(argument) == optionmap.end()) {
+      std::cerr << "Unknown argument " << argument << "\n";
+      return false;
     }
 
-    if (strcmp("-o", argv[i]) == 0) {
+    if (argument == "-o") {
       if (i + 1 == argc) {
         std::cerr << "Missing output prefix" << std::endl;
-        usage(std::cerr);
-        return 1;
+        return false;
       }
-      outputprefix = argv[++i];
+      options.outputprefix = arguments[++i];
       continue;
-    } else if (strcmp("-f", argv[i]) == 0) {
+    } else if (argument == "-f") {
       if (i + 1 == argc) {
         std::cerr << "Missing maze input file" << std::endl;
-        usage(std::cerr);
-        return 1;
+        return false;
       }
-      infile = argv[++i];
+      options.infile = arguments[++i];
       continue;
-    } else if (strcmp("--help", argv[i]) == 0) {
-      usage(std::cout);
-      return 0;
+    } else if (argument == "-c") {
+      if (i + 1 == argc) {
+        std::cerr << "Missing cache directory" << std::endl;
+        return false;
+      }
+      options.cachedirectory = arguments[++i];
+      continue;
+    } else if (argument == "-j") {
+      if (i + 1 == argc) {
+        std::cerr << "Missing job file" << std::endl;
+        return false;
+      }
+      options.jobfile = arguments[++i];
+      continue;
+    } else if (argument == "-r") {
+      if (i + 1 == argc) {
+        std::cerr << "Missing random seed" << std::endl;
+        return false;
+      }
+      try {
+        size_t length;
+        options.seed = std::stoull(arguments[++i], &length);
+        if (length != arguments[i].size())
+          throw std::invalid_argument(arguments[i]);
+      } catch (...) {
+        std::cerr << "Invalid random seed " << arguments[i] << "\n";
+        return false;
+      }
+      options.seeded = true;
+      continue;
+    } else if (argument == "-g") {
+      if (i + 1 == argc) {
+        std::cerr << "Missing growing tree policy" << std::endl;
+        return false;
+      }
+      options.policytext = arguments[++i];
+      try {
+        options.policy = GrowingTree::ParsePolicy(options.policytext);
+      } catch (const std::invalid_argument &error) {
+        std::cerr << error.what() << "\n";
+        return false;
+      }
+      continue;
+    } else if (argument == "--help") {
+      options.help = true;
+      return true;
     }
 
     if (i + 1 == argc) {
-      std::cerr << "Missing option for argument " << argv[i] << std::endl;
-      usage(std::cerr);
-      return 1;
+      std::cerr << "Missing option for argument " << argument << std::endl;
+      return false;
     }
     int x;
     try {
-      x = std::stoi(argv[i + 1]);
+      x = std::stoi(arguments[i + 1]);
     } catch (...) {
-      std::cerr << "Invalid argument " << argv[i + 1] << " for option "
-                << argv[i] << "\n";
-      usage(std::cerr);
-      return 1;
+      std::cerr << "Invalid argument " << arguments[i + 1] << " for option "
+                << argument << "\n";
+      return false;
     }
-    optionmap[argv[i++]] = x;
+    optionmap[arguments[i++]] = x;
   }
+  return true;
+}
 
-  Maze *maze;
-  SpanningtreeAlgorithm *algorithm;
-
+// Checks that the options describe a maze which can be generated, and
+// describes it, prints the error and returns false otherwise
+bool CheckOptions(Options &options) {
+  auto &optionmap = options.optionmap;
   switch (optionmap["-m"]) {
     case 0:
       if (optionmap["-w"] < 1 or optionmap["-h"] < 1) {
         std::cerr << "Invalide size " << optionmap["-w"] << "x"
                   << optionmap["-h"] << " for rectangular maze\n";
-        usage(std::cerr);
-        return 1;
+        return false;
+      }
+      // Only streamed Eller mazes never number their cells
+      if (!RectangularGraph::Fits(optionmap["-w"], optionmap["-h"]) and
+          (optionmap["-a"] != 7 or optionmap["-p"] != 0)) {
+        std::cerr << "Rectangular maze of size " << optionmap["-w"] << "x"
+                  << optionmap["-h"] << " has more than "
+                  << RectangularGraph::maxcells
+                  << " cells, only Eller's algorithm without tiles streams "
+                     "larger ones\n";
+        return false;
       }
       std::cout << "Rectangular maze of size " << optionmap["-w"] << "x"
                 << optionmap["-h"] << "\n";
-      maze = new RectangularMaze(optionmap["-w"], optionmap["-h"]);
       break;
 
     case 1:
       if (optionmap["-s"] < 1) {
         std::cerr << "Invalide size " << optionmap["-s"]
                   << " for hexagonal maze with triangular lattice\n";
-        usage(std::cerr);
-        return 1;
+        return false;
       }
       std::cout << "Hexagonal maze with triangular lattice of size "
                 << optionmap["-s"] << "\n";
-      maze = new HexagonalMaze(optionmap["-s"]);
       break;
 
     case 2:
       if (optionmap["-s"] < 1) {
         std::cerr << "Invalide size " << optionmap["-s"]
                   << " for honeycomb maze\n";
-        usage(std::cerr);
-        return 1;
+        return false;
       }
       std::cout << "Honeycomb maze of size " << optionmap["-s"] << "\n";
-      maze = new HoneyCombMaze(optionmap["-s"]);
       break;
 
     case 3:
       if (optionmap["-s"] < 1) {
         std::cerr << "Invalide size " << optionmap["-s"]
                   << " for circular maze\n";
-        usage(std::cerr);
-        return 1;
+        return false;
       }
       std::cout << "Circular maze of size " << optionmap["-s"] << "\n";
-      maze = new CircularMaze(optionmap["-s"]);
       break;
 
     case 4:
       if (optionmap["-s"] < 1) {
         std::cerr << "Invalide size " << optionmap["-s"]
                   << " for circular maze with triangular lattice\n";
-        usage(std::cerr);
-        return 1;
+        return false;
       }
       std::cout << "Circular maze with triangular lattice of size "
                 << optionmap["-s"] << "\n";
-      maze = new CircularHexagonMaze(optionmap["-s"]);
       break;
 
     case 5:
-      if (infile == "") {
+      if (options.infile == "") {
         std::cerr
             << "Graph description file not provided for user-defined graph\n";
-        usage(std::cerr);
-        return 1;
+        return false;
       }
       std::cout << "User-defined graph\n";
-      maze = new UserMaze(infile);
       break;
 
     case 6:
       if (optionmap["-s"] < 1) {
         std::cerr << "Invalid size " << optionmap["-s"]
                   << " for triangular maze\n";
-        usage(std::cerr);
-        return 1;
+        return false;
       }
       std::cout << "Triangular maze of size " << optionmap["-s"] << "\n";
-      maze = new TriangularMaze(optionmap["-s"]);
       break;
 
     default:
       std::cerr << "Unknown maze type " << optionmap["-m"];
-      usage(std::cerr);
-      return 1;
+      return false;
   }
 
   switch (optionmap["-a"]) {
     case 0:
       std::cout << "Maze generation using Kruskal's algorithm\n";
-      algorithm = new Kruskal;
       break;
 
     case 1:
       std::cout << "Maze generation using Depth-first search\n";
-      algorithm = new DepthFirstSearch;
       break;
 
     case 2:
       std::cout << "Maze generation using Breadth-first search\n";
-      algorithm = new BreadthFirstSearch;
       break;
 
     case 3:
       std::cout << "Maze generation using Loop-erased random walk\n";
-      algorithm = new LoopErasedRandomWalk;
       break;
 
     case 4:
       std::cout << "Maze generation using Prim's algorithm\n";
-      algorithm = new Prim;
+      break;
+
+    case 5:
+      std::cout << "Maze generation using parallel Boruvka's algorithm\n";
+      break;
+
+    case 6:
+      std::cout << "Maze generation using parallel cycle popping\n";
+      break;
+
+    case 7:
+      if (optionmap["-m"] != 0) {
+        std::cerr << "Eller's algorithm only generates rectangular mazes\n";
+        return false;
+      }
+      std::cout << "Maze generation using Eller's algorithm\n";
+      break;
+
+    case 8:
+      if (optionmap["-m"] != 0 and optionmap["-m"] != 6) {
+        std::cerr << "Recursive division only generates rectangular and "
+                     "triangular mazes\n";
+        return false;
+      }
+      std::cout << "Maze generation using recursive division\n";
+      break;
+
+    case 9:
+    case 10:
+      if (optionmap["-m"] != 0 and optionmap["-m"] != 6) {
+        std::cerr << "Binary tree and sidewinder only generate rectangular "
+                     "and triangular mazes\n";
+        return false;
+      }
+      std::cout << "Maze generation using "
+                << (optionmap["-a"] == 9 ? "binary tree\n" : "sidewinder\n");
+      break;
+
+    case 11:
+      std::cout << "Maze generation using growing tree ("
+                << options.policytext << ")\n";
       break;
 
     default:
       std::cerr << "Unknown algorithm type " << optionmap["-a"];
-      usage(std::cerr);
-      return 1;
+      return false;
+  }
+
+  if (optionmap["-p"] != 0) {
+    if (optionmap["-p"] < 0 or optionmap["-m"] != 0) {
+      std::cerr << "Invalid tile size " << optionmap["-p"]
+                << ", tiles need a rectangular maze\n";
+      return false;
+    }
+    std::cout << "Carving tiles of size " << optionmap["-p"]
+              << " in parallel\n";
   }
 
   if (optionmap["-t"] < 0 or optionmap["-t"] > 1) {
     std::cerr << "Unknown output type " << optionmap["-a"];
+    return false;
+  }
+
+  if (optionmap["-n"] < 1) {
+    std::cerr << "Invalid maze count " << optionmap["-n"] << "\n";
+    return false;
+  }
+
+  if (optionmap["-d"] < 0 or optionmap["-d"] > 17) {
+    std::cerr << "Invalid number of decimals " << optionmap["-d"] << "\n";
+    return false;
+  }
+  return true;
+}
+
+Maze *NewMaze(Options &options) {
+  auto &optionmap = options.optionmap;
+  switch (optionmap["-m"]) {
+    case 0:
+      return new RectangularMaze(optionmap["-w"], optionmap["-h"]);
+    case 1:
+      return new HexagonalMaze(optionmap["-s"]);
+    case 2:
+      return new HoneyCombMaze(optionmap["-s"]);
+    case 3:
+      return new CircularMaze(optionmap["-s"]);
+    case 4:
+      return new CircularHexagonMaze(optionmap["-s"]);
+    case 5:
+      return new UserMaze(options.infile, options.cachedirectory);
+    case 6:
+      return new TriangularMaze(optionmap["-s"]);
+  }
+  return nullptr;
+}
+
+// Algorithm of the options, carving tiles with it if asked to
+SpanningtreeAlgorithm *NewAlgorithm(Options &options) {
+  auto &optionmap = options.optionmap;
+  int type = optionmap["-a"];
+  GrowingTree::Policy policy = options.policy;
+  if (optionmap["-p"] == 0) return NewAlgorithm(type, policy);
+  return new TiledSpanningTree(
+      optionmap["-w"], optionmap["-h"], optionmap["-p"], [type, policy]() {
+        return std::unique_ptr<SpanningtreeAlgorithm>(
+            NewAlgorithm(type, policy));
+      });
+}
+
+// Algorithms which generate rectangular mazes row by row write them while
+// they go
+bool Streamed(Options &options) {
+  auto &optionmap = options.optionmap;
+  int type = optionmap["-a"];
+  return optionmap["-m"] == 0 and optionmap["-p"] == 0 and
+         (type == 7 or type == 9 or type == 10);
+}
+
+void RunGnuplot(const std::string &outputprefix) {
+  system(("gnuplot '" + outputprefix + ".plt'").c_str());
+}
+
+// Generates every maze of the jobs. Mazes of the same type and size are
+// cloned from one initialised maze, and generated on all threads while
+// writer threads render the finished ones, with a bounded queue between
+// them so that memory does not grow with the number of mazes.
+int RunBatch(std::vector<Options> &jobs) {
+  struct Task {
+    int job, index;
+  };
+  std::vector<Task> tasks;
+  std::map<std::tuple<int, int, int, int, std::string>, std::unique_ptr<Maze>>
+      initialised;
+  std::vector<const Maze *> prototypes(jobs.size(), nullptr);
+  for (int job = 0; job < int(jobs.size()); ++job) {
+    auto &optionmap = jobs[job].optionmap;
+    for (int index = 0; index < optionmap["-n"]; ++index)
+      tasks.push_back({job, index});
+    if (Streamed(jobs[job])) continue;
+
+    int type = optionmap["-m"];
+    auto key = std::make_tuple(type, type == 0 ? optionmap["-w"] : 0,
+                               type == 0 ? optionmap["-h"] : 0,
+                               type == 0 or type == 5 ? 0 : optionmap["-s"],
+                               type == 5 ? jobs[job].infile : "");
+    auto &maze = initialised[key];
+    if (!maze) {
+      maze.reset(NewMaze(jobs[job]));
+      try {
+        maze->InitialiseGraph();
+      } catch (const std::invalid_argument &error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+      }
+    }
+    prototypes[job] = maze.get();
+  }
+  std::cout << "Generating " << tasks.size() << " mazes on " << Threads()
+            << " threads..." << std::endl;
+
+  auto outputprefix = [&](const Task &task) {
+    const Options &options = jobs[task.job];
+    if (options.optionmap.at("-n") == 1) return options.outputprefix;
+    return options.outputprefix + "-" + std::to_string(task.index);
+  };
+
+  BoundedQueue<std::pair<Task, std::unique_ptr<Maze>>> generated(Threads());
+  auto write = [&]() {
+    std::pair<Task, std::unique_ptr<Maze>> item;
+    while (generated.Pop(item)) {
+      std::string prefix = outputprefix(item.first);
+      auto &optionmap = jobs[item.first.job].optionmap;
+      if (optionmap["-t"] == 0) {
+        item.second->PrintMazeSVG(prefix, false, optionmap["-d"]);
+      } else {
+        item.second->PrintMazeGnuplot(prefix, false, optionmap["-d"]);
+        RunGnuplot(prefix);
+      }
+    }
+  };
+  std::vector<std::thread> writers;
+  for (int i = 0; i < std::max(1, Threads() / 2); ++i)
+    writers.emplace_back(write);
+
+  // Every thread keeps an algorithm per job, which reuses its buffers for
+  // the following mazes of the job
+  std::vector<std::vector<std::unique_ptr<SpanningtreeAlgorithm>>> algorithms(
+      jobs.size());
+  for (auto &threadalgorithms : algorithms) threadalgorithms.resize(Threads());
+  ParallelFor(tasks.size(), [&](int i) {
+    const Task &task = tasks[i];
+    Options &options = jobs[task.job];
+    auto &algorithm = algorithms[task.job][Worker()];
+    if (!algorithm) algorithm.reset(NewAlgorithm(options));
+    if (options.seeded) algorithm->Seed(options.seed + task.index);
+
+    if (!prototypes[task.job]) {
+      auto &optionmap = options.optionmap;
+      StreamedMaze streamedmaze(optionmap["-w"], optionmap["-h"]);
+      std::string prefix = outputprefix(task);
+      if (optionmap["-t"] == 0) {
+        streamedmaze.PrintMazeSVG(prefix, algorithm.get());
+      } else {
+        streamedmaze.PrintMazeGnuplot(prefix, algorithm.get());
+        RunGnuplot(prefix);
+      }
+      return;
+    }
+    auto maze = prototypes[task.job]->Clone();
+    maze->GenerateMaze(algorithm.get());
+    generated.Push({task, std::move(maze)});
+  });
+  generated.Close();
+  for (auto &writer : writers) writer.join();
+  std::cout << "Wrote " << tasks.size() << " mazes" << std::endl;
+  return 0;
+}
+
+// Reads a job file, where every line holds the arguments of a job as on the
+// command line. Arguments given on the command line apply to every job.
+bool ReadJobs(const Options &defaults, std::vector<Options> &jobs) {
+  std::ifstream in(defaults.jobfile);
+  if (!in) {
+    std::cerr << "Error opening job file " << defaults.jobfile << "\n";
+    return false;
+  }
+  int number = 0;
+  for (std::string line; std::getline(in, line);) {
+    ++number;
+    std::istringstream stream(line);
+    std::vector<std::string> arguments{
+        std::istream_iterator<std::string>(stream),
+        std::istream_iterator<std::string>()};
+    if (arguments.empty() or arguments[0][0] == '#') continue;
+    Options job = defaults;
+    job.jobfile = "";
+    if (!ParseArguments(arguments, job) or job.help or job.jobfile != "") {
+      std::cerr << "Invalid job on line " << number << " of "
+                << defaults.jobfile << "\n";
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!ParseArguments({argv + 1, argv + argc}, options)) {
     usage(std::cerr);
     return 1;
   }
+  if (options.help) {
+    usage(std::cout);
+    return 0;
+  }
+
+  // Several mazes per process, from a count or a job file
+  if (options.jobfile != "" or options.optionmap["-n"] != 1) {
+    std::vector<Options> jobs;
+    if (options.jobfile == "")
+      jobs.push_back(options);
+    else if (!ReadJobs(options, jobs))
+      return 1;
+    for (auto &job : jobs) {
+      if (!CheckOptions(job)) {
+        usage(std::cerr);
+        return 1;
+      }
+    }
+    return RunBatch(jobs);
+  }
 
+  if (!CheckOptions(options)) {
+    usage(std::cerr);
+    return 1;
+  }
+  auto &optionmap = options.optionmap;
+  std::string outputprefix = options.outputprefix;
+  SpanningtreeAlgorithm *algorithm = NewAlgorithm(options);
+  if (options.seeded) algorithm->Seed(options.seed);
+
+  if (Streamed(options)) {
+    StreamedMaze streamedmaze(optionmap["-w"], optionmap["-h"]);
+    if (optionmap["-t"] == 0) {
+      std::cout << "Generating and rendering maze to '" << outputprefix
+                << ".svg'..." << std::endl;
+      streamedmaze.PrintMazeSVG(outputprefix, algorithm);
+    } else {
+      std::cout << "Generating maze and exporting plotting parameters to '"
+                << outputprefix << ".plt' ..." << std::endl;
+      streamedmaze.PrintMazeGnuplot(outputprefix, algorithm);
+      std::cout << "Rendering maze to '" << outputprefix
+                << ".png' using gnuplot..." << std::endl;
+      RunGnuplot(outputprefix);
+    }
+    return 0;
+  }
+
+  Maze *maze = NewMaze(options);
   std::cout << "Initialising graph..." << std::endl;
-  maze->InitialiseGraph();
+  try {
+    maze->InitialiseGraph();
+  } catch (const std::invalid_argument &error) {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
   std::cout << "Generating maze..." << std::endl;
   maze->GenerateMaze(algorithm);
   if (optionmap["-t"] == 0) {
     std::cout << "Rendering maze to '" << outputprefix << ".svg'..."
               << std::endl;
-    maze->PrintMazeSVG(outputprefix);
+    maze->PrintMazeSVG(outputprefix, false, optionmap["-d"]);
   } else {
     std::cout << "Exporting maze plotting parameters to '" << outputprefix
               << ".plt' ..." << std::endl;
-    maze->PrintMazeGnuplot(outputprefix);
+    maze->PrintMazeGnuplot(outputprefix, false, optionmap["-d"]);
     std::cout << "Rendering maze to '" << outputprefix
               << ".png' using gnuplot..." << std::endl;
-    system(("gnuplot '" + outputprefix + ".plt'").c_str());
+    RunGnuplot(outputprefix);
   }
   return 0;
 }
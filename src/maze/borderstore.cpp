@@ -0,0 +1,105 @@
+#include "borderstore.h"
+
+namespace {
+size_t Aligned(size_t bytes) { return (bytes + 7) / 8 * 8; }
+}  // namespace
+
+BorderStore::BorderStore()
+    : edges_(0), lines_(0), arcs_(0), single_(true), index_(nullptr) {}
+
+BorderStore::BorderStore(const std::vector<BorderRecord>& records)
+    : edges_(records.size()), lines_(0), arcs_(0), single_(true) {
+  for (const auto& record : records) {
+    ++(record.arc ? arcs_ : lines_);
+    for (int i = 0; i < (record.arc ? 5 : 4); ++i)
+      single_ = single_ and double(float(record.values[i])) == record.values[i];
+  }
+
+  // Words keep every column aligned for doubles
+  auto words = std::make_shared<std::vector<uint64_t>>(
+      Size(edges_, lines_, arcs_, single_) / 8);
+  char* data = reinterpret_cast<char*>(words->data());
+  buffer_ = std::shared_ptr<const char>(words, data);
+  Locate();
+
+  auto index = reinterpret_cast<uint32_t*>(data);
+  int lines = 0, arcs = 0;
+  for (int edgeid = 0; edgeid < edges_; ++edgeid) {
+    const BorderRecord& record = records[edgeid];
+    int row = record.arc ? arcs++ : lines++, first = record.arc ? 4 : 0;
+    index[edgeid] = record.arc ? arcbit | row : row;
+    for (int i = 0; i < (record.arc ? 5 : 4); ++i) {
+      char* column = const_cast<char*>(columns_[first + i]);
+      if (single_)
+        reinterpret_cast<float*>(column)[row] = record.values[i];
+      else
+        reinterpret_cast<double*>(column)[row] = record.values[i];
+    }
+  }
+}
+
+BorderStore::BorderStore(int edges, int lines, int arcs, bool single,
+                         std::shared_ptr<const char> buffer)
+    : edges_(edges),
+      lines_(lines),
+      arcs_(arcs),
+      single_(single),
+      buffer_(buffer) {
+  Locate();
+}
+
+size_t BorderStore::Size(int edges, int lines, int arcs, bool single) {
+  size_t width = single ? sizeof(float) : sizeof(double);
+  return Aligned(sizeof(uint32_t) * edges) + 4 * Aligned(width * lines) +
+         5 * Aligned(width * arcs);
+}
+
+bool BorderStore::Valid() const {
+  for (int edgeid = 0; edgeid < edges_; ++edgeid) {
+    uint32_t index = index_[edgeid], row = index & ~arcbit;
+    if (row >= uint32_t(index & arcbit ? arcs_ : lines_)) return false;
+  }
+  return true;
+}
+
+void BorderStore::Locate() {
+  size_t width = single_ ? sizeof(float) : sizeof(double);
+  const char* position = buffer_.get();
+  index_ = reinterpret_cast<const uint32_t*>(position);
+  position += Aligned(sizeof(uint32_t) * edges_);
+  for (int i = 0; i < 9; ++i) {
+    columns_[i] = position;
+    position += Aligned(width * (i < 4 ? lines_ : arcs_));
+  }
+}
+
+BorderRecord BorderStore::Record(int edgeid) const {
+  uint32_t index = index_[edgeid];
+  BorderRecord record = {0, {0, 0, 0, 0, 0}};
+  record.arc = (index & arcbit) != 0;
+  int row = index & ~arcbit, first = record.arc ? 4 : 0;
+  for (int i = 0; i < (record.arc ? 5 : 4); ++i)
+    record.values[i] = Value(first + i, row);
+  return record;
+}
+
+std::shared_ptr<CellBorder> BorderStore::Border(int edgeid) const {
+  BorderRecord record = Record(edgeid);
+  const double* values = record.values;
+  if (record.arc)
+    return std::make_shared<ArcBorder>(values[0], values[1], values[2],
+                                       values[3], values[4]);
+  return std::make_shared<LineBorder>(values[0], values[1], values[2],
+                                      values[3]);
+}
+
+void BorderStore::Write(int edgeid, MazeWriter& writer) const {
+  uint32_t index = index_[edgeid];
+  int row = index & ~arcbit;
+  if (index & arcbit) {
+    writer.Arc(Value(4, row), Value(5, row), Value(6, row), Value(7, row),
+               Value(8, row));
+  } else {
+    writer.Line(Value(0, row), Value(1, row), Value(2, row), Value(3, row));
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef BORDERSTORE_H
+#define BORDERSTORE_H
+
+#include "cellborder.h"
+#include "mazewriter.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Geometry of the walls of a graph without a lattice, in a table of lines
+// and a table of arcs stored column by column. Every edge id indexes a row
+// of one table. Coordinates are stored as float when every value converts
+// exactly, and as double otherwise, so the store never changes a wall.
+class BorderStore {
+ public:
+  BorderStore();
+  // Stores the walls of edges 0, 1, ... in order
+  explicit BorderStore(const std::vector<BorderRecord>&);
+  // Store over a buffer in the layout of Data(), such as a mapped file. The
+  // buffer is kept alive by the store.
+  BorderStore(int edges, int lines, int arcs, bool single,
+              std::shared_ptr<const char> buffer);
+
+  int Edges() const { return edges_; }
+  int Lines() const { return lines_; }
+  int Arcs() const { return arcs_; }
+  // Whether the coordinates are stored as float
+  bool Single() const { return single_; }
+  // The index by edge id, then the line and arc columns, each array
+  // starting at a multiple of 8 bytes
+  const char* Data() const { return buffer_.get(); }
+  static size_t Size(int edges, int lines, int arcs, bool single);
+  // Whether every edge indexes a row of its table, which a store over a
+  // buffer read from elsewhere has to be checked for once
+  bool Valid() const;
+
+  BorderRecord Record(int edgeid) const;
+  std::shared_ptr<CellBorder> Border(int edgeid) const;
+  // Writes the wall of an edge without allocating a border
+  void Write(int edgeid, MazeWriter&) const;
+
+ private:
+  // Rows of arcs have the top bit of their index set
+  static const uint32_t arcbit = 0x80000000u;
+  int edges_, lines_, arcs_;
+  bool single_;
+  std::shared_ptr<const char> buffer_;
+  const uint32_t* index_;
+  // x1, y1, x2, y2 of the lines, then cx, cy, r, theta1, theta2 of the arcs
+  const char* columns_[9];
+
+  // Points the index and the columns into the buffer
+  void Locate();
+  double Value(int column, int row) const {
+    return single_ ? reinterpret_cast<const float*>(columns_[column])[row]
+                   : reinterpret_cast<const double*>(columns_[column])[row];
+  }
+};
+
+#endif /* end of include guard: BORDERSTORE_H */
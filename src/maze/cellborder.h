@@ -1,18 +1,20 @@
 #ifndef CELLBORDER_H
 #define CELLBORDER_H
 
-#include <string>
+#include <cstdint>
+#include <tuple>
+
+class MazeWriter;
 
 class CellBorder {
  public:
-  virtual std::string GnuplotPrintString(const std::string&) const = 0;
-  virtual std::string SVGPrintString(const std::string&) const = 0;
+  // Passes the wall to the writer as a line or an arc
+  virtual void Write(MazeWriter&) const = 0;
 };
 
 class LineBorder : public CellBorder {
  public:
-  virtual std::string GnuplotPrintString(const std::string&) const;
-  virtual std::string SVGPrintString(const std::string&) const;
+  virtual void Write(MazeWriter&) const;
   LineBorder(double, double, double, double);
   LineBorder(std::tuple<double, double, double, double>);
 
@@ -22,12 +24,18 @@ class LineBorder : public CellBorder {
 
 class ArcBorder : public CellBorder {
  public:
-  virtual std::string GnuplotPrintString(const std::string&) const;
-  virtual std::string SVGPrintString(const std::string&) const;
+  virtual void Write(MazeWriter&) const;
   ArcBorder(double, double, double, double, double);
 
  protected:
   double cx_, cy_, r_, theta1_, theta2_;
 };
 
+// Plain geometry of a line from (x1, y1) to (x2, y2) or an arc around
+// (cx, cy) of radius r from theta1 to theta2
+struct BorderRecord {
+  int32_t arc;
+  double values[5];
+};
+
 #endif /* end of include guard: CELLBORDER_H */
@@ -0,0 +1,27 @@
+#include "mappedfile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::shared_ptr<const char> MapFile(const std::string& filename,
+                                    size_t& length) {
+  length = 0;
+  int file = open(filename.c_str(), O_RDONLY);
+  if (file < 0) return nullptr;
+  struct stat status;
+  void* data = MAP_FAILED;
+  if (fstat(file, &status) == 0 and status.st_size > 0) {
+    length = status.st_size;
+    data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+  }
+  // The mapping outlives the descriptor
+  close(file);
+  if (data == MAP_FAILED) {
+    length = 0;
+    return nullptr;
+  }
+  return std::shared_ptr<const char>(
+      static_cast<const char*>(data),
+      [length](const char* data) { munmap(const_cast<char*>(data), length); });
+}
@@ -0,0 +1,13 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Maps a whole file read-only into memory, which stays mapped while any copy
+// of the pointer lives. Returns nullptr for files which cannot be opened or
+// are empty.
+std::shared_ptr<const char> MapFile(const std::string&, size_t& length);
+
+#endif /* end of include guard: MAPPEDFILE_H */
@@ -6,6 +6,8 @@
 #endif
 
 #include "cellborder.h"
+#include "depthfirstsearch.h"
+#include "mazewriter.h"
 #include "spanningtreealgorithm.h"
 #include <memory>
 #include <vector>
@@ -13,19 +15,52 @@
 class Maze {
  public:
   Maze(int = 0, int = 0, int = 1);
+  virtual ~Maze() {}
+  // Copy of the maze sharing its graph and geometry, so that many mazes of
+  // the same type and size only initialise the graph once
+  virtual std::unique_ptr<Maze> Clone() const = 0;
   void GenerateMaze(SpanningtreeAlgorithm*);
-  void PrintMazeGnuplot(const std::string&, bool = false) const;
-  void PrintMazeSVG(const std::string&, bool = false) const;
+  // Output prefix, whether to draw the solution and the number of decimals
+  void PrintMazeGnuplot(const std::string&, bool = false,
+                        int precision = 6) const;
+  void PrintMazeSVG(const std::string&, bool = false, int precision = 6) const;
   virtual void InitialiseGraph() = 0;
 
  protected:
   // Solving a maze is equivalent to finding a path in a graph
   int vertices_;
-  Graph adjacencylist_, solution_;
+  std::shared_ptr<const Graph> graph_;
   int startvertex_, endvertex_;
+  // Edges of mazes without a lattice topology, kept until the graph is built
+  std::vector<std::pair<int, int>> edges_;
+  // Whether the wall of an edge is still standing, by edge id
+  Bitset walls_;
+  // Walls of every edge, which each generated maze starts from, shared
+  // between clones
+  std::shared_ptr<const Bitset> allwalls_;
+  // Ids of the boundary walls, which are rendered but never traversed
+  std::vector<int> boundary_;
+  // Ids of the edges on the path from the end vertex to the start vertex
+  std::vector<int> solution_;
+  // Keeps its buffers between solves, as solution_ does
+  DepthFirstSearch solver_;
 
-  void RemoveBorders(const std::vector<std::pair<int, int>>&);
-  void Solve(const std::vector<std::pair<int, int>>&);
+  // Adds an edge, numbered in insertion order. An edge to vertex -1 is a
+  // boundary wall.
+  void AddEdge(int, int);
+  void AddBoundary(int);
+  // Builds the graph of the added edges unless the maze has set its own
+  // topology, and raises all walls
+  void FinaliseGraph();
+  // Geometry of the wall of an edge
+  virtual std::shared_ptr<CellBorder> GetBorder(int) const = 0;
+  // Writes the wall of an edge, through GetBorder unless the maze can write
+  // it without allocating a border
+  virtual void PrintWall(MazeWriter&, int) const;
+  // Finds the path from the start to the end vertex through the passages
+  void Solve();
+  // Writes the boundary and every wall still standing
+  void PrintWalls(MazeWriter&) const;
   virtual std::tuple<double, double, double, double> GetCoordinateBounds()
       const = 0;
 };
@@ -0,0 +1,200 @@
+#include "mazewriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+void Open(std::ofstream& file, const std::string& filename) {
+  file.open(filename);
+  if (!file) {
+    std::cerr << "Error opening " << filename << " for writing.\n";
+    std::cerr << "Terminating.";
+    exit(1);
+  }
+}
+
+// Room for any number written by Number
+const size_t numberlength = 64;
+}  // namespace
+
+BufferedWriter::BufferedWriter(const std::string& filename, int precision)
+    : precision_(std::clamp(precision, 0, 17)), buffer_(1 << 20), size_(0) {
+  Open(file_, filename);
+}
+
+BufferedWriter::~BufferedWriter() { Flush(); }
+
+void BufferedWriter::Flush() {
+  file_.write(buffer_.data(), size_);
+  size_ = 0;
+}
+
+void BufferedWriter::Text(std::string_view text) {
+  if (size_ + text.size() > buffer_.size()) {
+    Flush();
+    if (text.size() > buffer_.size()) {
+      file_.write(text.data(), text.size());
+      return;
+    }
+  }
+  std::memcpy(buffer_.data() + size_, text.data(), text.size());
+  size_ += text.size();
+}
+
+void BufferedWriter::Number(double value) {
+  if (size_ + numberlength > buffer_.size()) Flush();
+  char *begin = buffer_.data() + size_, *end = begin + numberlength, *last;
+  if (!(std::abs(value) < 1e15)) {
+    // Huge or not finite, in the shortest form which reads back the same
+    last = std::to_chars(begin, end, value).ptr;
+  } else if (value == std::trunc(value)) {
+    last = std::to_chars(begin, end, (long long)value).ptr;
+  } else {
+    last = std::to_chars(begin, end, value, std::chars_format::fixed,
+                         precision_)
+               .ptr;
+    // Trailing zeros of the fraction carry nothing
+    if (precision_ > 0) {
+      while (last[-1] == '0') --last;
+      if (last[-1] == '.') --last;
+    }
+  }
+  size_ = last - buffer_.data();
+}
+
+SVGWriter::SVGWriter(const std::string& outputprefix,
+                     std::tuple<double, double, double, double> bounds,
+                     int precision)
+    : BufferedWriter(outputprefix + ".svg", precision) {
+  double xmin, ymin, xmax, ymax;
+  std::tie(xmin, ymin, xmax, ymax) = bounds;
+  int xresolution = (xmax - xmin + 2) * 30,
+      yresolution = (ymax - ymin + 2) * 30;
+
+  Text("<svg width=\"");
+  Number(xresolution);
+  Text("\" height=\"");
+  Number(yresolution);
+  Text("\" xmlns=\"http://www.w3.org/2000/svg\">\n<g transform=\"translate(");
+  Number((1 - xmin) * 30);
+  Text(",");
+  Number(yresolution - (1 - ymin) * 30);
+  Text(") scale(1,-1)\">\n<rect x=\"");
+  Number((xmin - 1) * 30);
+  Text("\" y=\"");
+  Number((ymin - 1) * 30);
+  Text("\" width=\"");
+  Number(xresolution);
+  Text("\" height=\"");
+  Number(yresolution);
+  Text("\" fill=\"white\"/>\n");
+}
+
+SVGWriter::~SVGWriter() { Text("</g>\n</svg>\n"); }
+
+void SVGWriter::Line(double x1, double y1, double x2, double y2) {
+  Text("<line x1=\"");
+  Number(x1 * 30);
+  Text("\" x2=\"");
+  Number(x2 * 30);
+  Text("\" y1=\"");
+  Number(y1 * 30);
+  Text("\" y2=\"");
+  Number(y2 * 30);
+  Text("\" stroke=\"black\" stroke-linecap=\"round\" stroke-width=\"3\"/>\n");
+}
+
+void SVGWriter::Arc(double cx, double cy, double r, double theta1,
+                    double theta2) {
+  double x1 = cx + r * cos(theta1), y1 = cy + r * sin(theta1);
+  double x2 = cx + r * cos(theta2), y2 = cy + r * sin(theta2);
+  Text("<path d=\"M ");
+  Number(x2 * 30);
+  Text(" ");
+  Number(y2 * 30);
+  Text(" A ");
+  Number(r * 30);
+  Text(" ");
+  Number(r * 30);
+  Text(", 0, 0, 0, ");
+  Number(x1 * 30);
+  Text(" ");
+  Number(y1 * 30);
+  Text("\" stroke=\"black\" stroke-linecap=\"round\" stroke-width=\"3\" "
+       "fill=\"none\"/>\n");
+}
+
+GnuplotWriter::GnuplotWriter(
+    const std::string& outputprefix,
+    std::tuple<double, double, double, double> bounds, int precision)
+    : BufferedWriter(outputprefix + ".plt", precision) {
+  Text("unset border\n");
+  Text("unset tics\n");
+  Text("set samples 15\n");
+  Text("set lmargin at screen 0\n");
+  Text("set rmargin at screen 1\n");
+  Text("set bmargin at screen 0\n");
+  Text("set tmargin at screen 1\n");
+
+  double xmin, ymin, xmax, ymax;
+  std::tie(xmin, ymin, xmax, ymax) = bounds;
+  Text("set xrange[");
+  Number(xmin - 1);
+  Text(":");
+  Number(xmax + 1);
+  Text("]\nset yrange[");
+  Number(ymin - 1);
+  Text(":");
+  Number(ymax + 1);
+  Text("]\n");
+
+  int xresolution = (xmax - xmin + 2) * 30,
+      yresolution = (ymax - ymin + 2) * 30;
+  Text("set term pngcairo mono enhanced size ");
+  Number(xresolution);
+  Text(",");
+  Number(yresolution);
+  Text("\n");
+
+  Text("set output '");
+  Text(outputprefix);
+  Text(".png'\n");
+  Text("set multiplot\n");
+}
+
+GnuplotWriter::~GnuplotWriter() {
+  Text("plot 1/0 notitle\n");
+  Text("unset multiplot\n");
+  Text("set output\n");
+}
+
+void GnuplotWriter::Line(double x1, double y1, double x2, double y2) {
+  Text("set arrow from ");
+  Number(x1);
+  Text(",");
+  Number(y1);
+  Text(" to ");
+  Number(x2);
+  Text(",");
+  Number(y2);
+  Text(" nohead lc'black' lw 2\n");
+}
+
+void GnuplotWriter::Arc(double cx, double cy, double r, double theta1,
+                        double theta2) {
+  Text("set parametric; plot [");
+  Number(theta1);
+  Text(":");
+  Number(theta2);
+  Text("] ");
+  Number(cx);
+  Text("+cos(t)*");
+  Number(r);
+  Text(",");
+  Number(cy);
+  Text("+sin(t)*");
+  Number(r);
+  Text(" w l lc'black' lw 2 notitle;unset parametric\n");
+}
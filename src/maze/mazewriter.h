@@ -0,0 +1,67 @@
+#ifndef MAZEWRITER_H
+#define MAZEWRITER_H
+
+#include "cellborder.h"
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+// Writes the walls of a maze one at a time, so that mazes which are never
+// held in memory as a whole can be written while they are generated. The
+// file is completed when the writer is destroyed.
+class MazeWriter {
+ public:
+  virtual ~MazeWriter() {}
+  void Write(const CellBorder& border) { border.Write(*this); }
+  // Wall from (x1, y1) to (x2, y2)
+  virtual void Line(double x1, double y1, double x2, double y2) = 0;
+  // Wall around (cx, cy) of radius r from theta1 to theta2
+  virtual void Arc(double cx, double cy, double r, double theta1,
+                   double theta2) = 0;
+};
+
+// Writer formatting into a buffer which goes to the file in large blocks,
+// so that writing a wall neither allocates nor makes a system call.
+// Integral numbers are written without a fraction, others with at most the
+// given number of decimals, up to 17.
+class BufferedWriter : public MazeWriter {
+ protected:
+  BufferedWriter(const std::string& filename, int precision);
+  ~BufferedWriter();
+  void Text(std::string_view);
+  void Number(double);
+
+ private:
+  std::ofstream file_;
+  int precision_;
+  std::vector<char> buffer_;
+  size_t size_;
+
+  void Flush();
+};
+
+class SVGWriter : public BufferedWriter {
+ public:
+  // Output prefix, the coordinate bounds xmin, ymin, xmax, ymax and the
+  // number of decimals
+  SVGWriter(const std::string&, std::tuple<double, double, double, double>,
+            int precision = 6);
+  ~SVGWriter();
+  void Line(double, double, double, double);
+  void Arc(double, double, double, double, double);
+};
+
+// Writes a gnuplot script which renders the maze to a png file
+class GnuplotWriter : public BufferedWriter {
+ public:
+  GnuplotWriter(const std::string&,
+                std::tuple<double, double, double, double>,
+                int precision = 6);
+  ~GnuplotWriter();
+  void Line(double, double, double, double);
+  void Arc(double, double, double, double, double);
+};
+
+#endif /* end of include guard: MAZEWRITER_H */
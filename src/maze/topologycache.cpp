@@ -0,0 +1,185 @@
+#include "topologycache.h"
+#include "mappedfile.h"
+#include "random.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+const char magic[8] = {'M', 'A', 'Z', 'E', 'T', 'O', 'P', 'O'};
+// Changes whenever the layout below does
+const uint32_t version = 2;
+
+// The header is followed by the offsets, neighbors and edge ids of the
+// compressed graph, the boundary edge ids and the border store. Each array
+// starts at a multiple of 8 bytes.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  int32_t type, size;
+  int32_t vertices, edges, maxdegree, boundaries;
+  // Rows of the border store, and whether it holds floats
+  int32_t lines, arcs, single;
+  uint64_t inputhash;
+  int64_t halfedges;
+  double bounds[4];
+};
+
+size_t Aligned(size_t bytes) { return (bytes + 7) / 8 * 8; }
+
+// Hash of the length and contents of a file, 0 if it cannot be read
+uint64_t HashFile(const std::string& filename) {
+  size_t length;
+  auto data = MapFile(filename, length);
+  if (!data) return 0;
+  uint64_t hash = Random::Mix(length);
+  size_t words = length / 8;
+  for (size_t i = 0; i < words; ++i) {
+    uint64_t word;
+    std::memcpy(&word, data.get() + 8 * i, 8);
+    hash = Random::Mix(hash ^ word) + i;
+  }
+  uint64_t last = 0;
+  std::memcpy(&last, data.get() + 8 * words, length - 8 * words);
+  return Random::Mix(hash ^ last);
+}
+}  // namespace
+
+TopologyCache::TopologyCache(const std::string& directory, int type, int size,
+                             const std::string& input)
+    : type_(type), size_(size), inputhash_(0) {
+  filename_ = directory + "/topology-" + std::to_string(type) + "-" +
+              std::to_string(size);
+  if (input != "") {
+    inputhash_ = HashFile(input);
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx",
+                  (unsigned long long)inputhash_);
+    filename_ += std::string("-") + hex;
+  }
+  filename_ += ".bin";
+}
+
+bool TopologyCache::Load(Topology& topology) const {
+  size_t length;
+  auto data = MapFile(filename_, length);
+  if (!data or length < sizeof(Header)) return false;
+  Header header;
+  std::memcpy(&header, data.get(), sizeof(Header));
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 or
+      header.version != version or header.type != type_ or
+      header.size != size_ or header.inputhash != inputhash_ or
+      header.vertices < 0 or header.edges < 0 or header.boundaries < 0 or
+      header.halfedges < 0 or header.lines < 0 or header.arcs < 0 or
+      (header.single != 0 and header.single != 1) or
+      header.lines + int64_t(header.arcs) != header.edges)
+    return false;
+
+  size_t offsets = Aligned(sizeof(Header)),
+         neighbors = offsets + Aligned(4 * (header.vertices + size_t(1))),
+         edgeids = neighbors + Aligned(4 * header.halfedges),
+         boundary = edgeids + Aligned(4 * header.halfedges),
+         borders = boundary + Aligned(4 * size_t(header.boundaries)),
+         end = borders + BorderStore::Size(header.edges, header.lines,
+                                           header.arcs, header.single);
+  if (length != end) return false;
+  auto array = [&](size_t offset) {
+    return reinterpret_cast<const int*>(data.get() + offset);
+  };
+
+  // Checked once here, so that a damaged file fails to load instead of
+  // reading out of bounds later
+  const int* offset = array(offsets);
+  if (header.maxdegree < 0 or offset[0] != 0 or
+      offset[header.vertices] != header.halfedges)
+    return false;
+  for (int u = 0; u < header.vertices; ++u) {
+    if (offset[u + 1] < offset[u] or
+        offset[u + 1] - offset[u] > header.maxdegree)
+      return false;
+  }
+  auto within = [](const int* values, size_t count, int limit) {
+    for (size_t i = 0; i < count; ++i) {
+      if (values[i] < 0 or values[i] >= limit) return false;
+    }
+    return true;
+  };
+  if (!within(array(neighbors), header.halfedges, header.vertices) or
+      !within(array(edgeids), header.halfedges, header.edges) or
+      !within(array(boundary), header.boundaries, header.edges))
+    return false;
+  BorderStore store(header.edges, header.lines, header.arcs, header.single,
+                    std::shared_ptr<const char>(data, data.get() + borders));
+  if (!store.Valid()) return false;
+
+  topology.graph = std::make_shared<CompressedGraph>(
+      header.vertices, header.edges, header.maxdegree, offset,
+      array(neighbors), array(edgeids), data);
+  topology.boundary.assign(array(boundary),
+                           array(boundary) + header.boundaries);
+  topology.borders = store;
+  topology.bounds = std::make_tuple(header.bounds[0], header.bounds[1],
+                                    header.bounds[2], header.bounds[3]);
+  return true;
+}
+
+void TopologyCache::Store(const Topology& topology) const {
+  const Graph& graph = *topology.graph;
+  // Zeroed, so that the padding of the file does not vary
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.type = type_;
+  header.size = size_;
+  header.vertices = graph.Vertices();
+  header.edges = graph.Edges();
+  header.maxdegree = graph.MaxDegree();
+  header.boundaries = topology.boundary.size();
+  header.lines = topology.borders.Lines();
+  header.arcs = topology.borders.Arcs();
+  header.single = topology.borders.Single();
+  header.inputhash = inputhash_;
+  std::tie(header.bounds[0], header.bounds[1], header.bounds[2],
+           header.bounds[3]) = topology.bounds;
+
+  // Collect the adjacency through the graph interface, so any graph can be
+  // stored
+  std::vector<int> offsets(1, 0), neighbors, edgeids;
+  std::vector<int> vertexneighbors(graph.MaxDegree()),
+      vertexedgeids(graph.MaxDegree());
+  for (int u = 0; u < graph.Vertices(); ++u) {
+    int degree =
+        graph.Neighbors(u, vertexneighbors.data(), vertexedgeids.data());
+    neighbors.insert(neighbors.end(), vertexneighbors.begin(),
+                     vertexneighbors.begin() + degree);
+    edgeids.insert(edgeids.end(), vertexedgeids.begin(),
+                   vertexedgeids.begin() + degree);
+    offsets.push_back(neighbors.size());
+  }
+  header.halfedges = neighbors.size();
+
+  // Written under a temporary name and renamed, so concurrent runs never
+  // map a partial file
+  std::string temporary = filename_ + ".tmp";
+  std::ofstream file(temporary, std::ios::binary);
+  auto write = [&](const void* data, size_t bytes) {
+    file.write(static_cast<const char*>(data), bytes);
+    static const char padding[8] = {};
+    file.write(padding, Aligned(bytes) - bytes);
+  };
+  write(&header, sizeof(Header));
+  write(offsets.data(), 4 * offsets.size());
+  write(neighbors.data(), 4 * neighbors.size());
+  write(edgeids.data(), 4 * edgeids.size());
+  write(topology.boundary.data(), 4 * topology.boundary.size());
+  write(topology.borders.Data(),
+        BorderStore::Size(header.edges, header.lines, header.arcs,
+                          header.single));
+  file.close();
+  if (!file or std::rename(temporary.c_str(), filename_.c_str()) != 0) {
+    std::cerr << "Could not write topology cache " << filename_ << "\n";
+    std::remove(temporary.c_str());
+  }
+}
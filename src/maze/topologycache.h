@@ -0,0 +1,46 @@
+#ifndef TOPOLOGYCACHE_H
+#define TOPOLOGYCACHE_H
+
+#include "borderstore.h"
+#include "graph.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Versioned binary file holding an initialised graph with its boundary walls
+// and the geometry of every wall. Later runs map the file and use its arrays
+// in place instead of building the graph again. Files are named by maze
+// type, size and a hash of the input file, so a changed input never reads a
+// stale cache.
+class TopologyCache {
+ public:
+  struct Topology {
+    std::shared_ptr<const Graph> graph;
+    std::vector<int> boundary;
+    // Geometry of the wall of every edge, by edge id
+    BorderStore borders;
+    std::tuple<double, double, double, double> bounds;
+  };
+
+  // Cache in a directory of the maze type and size, read from an input file
+  // if it has one
+  TopologyCache(const std::string& directory, int type, int size,
+                const std::string& input = "");
+  // Maps the cached topology, returns false if there is none or the file
+  // does not hold a valid topology: offsets must not decrease or exceed the
+  // maximum degree, and every vertex, edge, boundary and border row index
+  // must be in range
+  bool Load(Topology&) const;
+  // Writes the topology, failing to write only loses the cache
+  void Store(const Topology&) const;
+  const std::string& Filename() const { return filename_; }
+
+ private:
+  int type_, size_;
+  uint64_t inputhash_;
+  std::string filename_;
+};
+
+#endif /* end of include guard: TOPOLOGYCACHE_H */
@@ -6,6 +6,9 @@
 class CircularHexagonMaze : public HexagonalMaze {
  public:
   CircularHexagonMaze(int);
+  std::unique_ptr<Maze> Clone() const {
+    return std::make_unique<CircularHexagonMaze>(*this);
+  }
 
  protected:
   virtual std::shared_ptr<CellBorder> GetEdge(int, int, int, int) const;
@@ -1,8 +1,9 @@
 #include "circularmaze.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
-CircularMaze::CircularMaze(int size) : size_(size) {
+CircularGraph::CircularGraph(int size) : size_(size) {
   ringnodecount_ = std::vector<int>(size_);
   ringnodeprefixsum_ = std::vector<int>(size_);
   ringnodecount_[0] = 1;
@@ -13,43 +14,83 @@ CircularMaze::CircularMaze(int size) : size_(size) {
     if (2 * M_PI * i / ringnodecount_[i - 1] > 2) ringnodecount_[i] *= 2;
     ringnodeprefixsum_[i] = ringnodeprefixsum_[i - 1] + ringnodecount_[i - 1];
   }
-  vertices_ = ringnodecount_.back() + ringnodeprefixsum_.back();
-  startvertex_ = ringnodeprefixsum_.back();
-  endvertex_ = startvertex_ + ringnodecount_.back() / 2;
+}
+
+std::pair<int, int> CircularGraph::NodeCoordinates(int node) const {
+  int i = std::upper_bound(ringnodeprefixsum_.begin(), ringnodeprefixsum_.end(),
+                           node) -
+          ringnodeprefixsum_.begin() - 1;
+  return {i, node - ringnodeprefixsum_[i]};
+}
+
+int CircularGraph::Vertices() const {
+  return ringnodeprefixsum_.back() + ringnodecount_.back();
+}
+
+int CircularGraph::Edges() const { return 3 * Vertices(); }
+
+int CircularGraph::MaxDegree() const { return 5; }
+
+int CircularGraph::Neighbors(int node, int* neighbors, int* edgeids) const {
+  auto [i, j] = NodeCoordinates(node);
+  int degree = 0;
+  auto add = [&](int neighbor, int edgeid) {
+    neighbors[degree] = neighbor;
+    edgeids[degree++] = edgeid;
+  };
+
+  if (i > 0) {
+    int n = ringnodecount_[i], offset = ringnodeprefixsum_[i];
+    add(ringnodeprefixsum_[i - 1] + (ringnodecount_[i - 1] * j) / n,
+        3 * node);
+    add(offset + (j + 1) % n, 3 * node + 1);
+    int left = offset + (j + n - 1) % n;
+    add(left, 3 * left + 1);
+  }
+
+  if (i < size_ - 1) {
+    // The outer ring has the same or twice the number of nodes
+    int ratio = ringnodecount_[i + 1] / ringnodecount_[i];
+    for (int k = j * ratio; k < (j + 1) * ratio; ++k) {
+      int child = ringnodeprefixsum_[i + 1] + k;
+      add(child, 3 * child);
+    }
+  }
+  return degree;
+}
+
+CircularMaze::CircularMaze(int size) : size_(size) {
+  lattice_ = std::make_shared<CircularGraph>(size);
+  vertices_ = lattice_->Vertices();
+  startvertex_ = lattice_->RingNodePrefixSum(size_ - 1);
+  endvertex_ = startvertex_ + lattice_->RingNodeCount(size_ - 1) / 2;
 }
 
 void CircularMaze::InitialiseGraph() {
   Maze::InitialiseGraph();
+  graph_ = lattice_;
 
-  for (int i = 1; i < size_; ++i) {
-    for (int j = 0; j < ringnodecount_[i]; ++j) {
-      int node = ringnodeprefixsum_[i] + j, nnode;
-      std::shared_ptr<CellBorder> ptr;
-
-      nnode = ringnodeprefixsum_[i - 1] +
-              (ringnodecount_[i - 1] * j) / ringnodecount_[i];
-      ptr = std::make_shared<ArcBorder>(
-          0, 0, i, j * 2 * M_PI / ringnodecount_[i] - M_PI / 2,
-          (j + 1) * 2 * M_PI / ringnodecount_[i] - M_PI / 2);
-      adjacencylist_[node].push_back({nnode, ptr});
-      adjacencylist_[nnode].push_back({node, ptr});
-
-      nnode = ringnodeprefixsum_[i] + ((j + 1) % ringnodecount_[i]);
-      double theta = (j + 1) * 2 * M_PI / ringnodecount_[i] - M_PI / 2;
-      ptr = std::make_shared<LineBorder>(i * cos(theta), i * sin(theta),
-                                         (i + 1) * cos(theta),
-                                         (i + 1) * sin(theta));
-      adjacencylist_[node].push_back({nnode, ptr});
-      adjacencylist_[nnode].push_back({node, ptr});
-
-      if (i == size_ - 1 and node != startvertex_ and node != endvertex_) {
-        ptr = std::make_shared<ArcBorder>(
-            0, 0, size_, j * 2 * M_PI / ringnodecount_[i] - M_PI / 2,
-            (j + 1) * 2 * M_PI / ringnodecount_[i] - M_PI / 2);
-        adjacencylist_[node].push_back({-1, ptr});
-      }
-    }
+  // Outer arcs, except entry and exit
+  for (int node = startvertex_ + 1; node < vertices_; ++node) {
+    if (node != endvertex_) AddBoundary(3 * node + 2);
+  }
+
+  FinaliseGraph();
+}
+
+std::shared_ptr<CellBorder> CircularMaze::GetBorder(int edgeid) const {
+  auto [i, j] = lattice_->NodeCoordinates(edgeid / 3);
+  int n = lattice_->RingNodeCount(i);
+
+  if (edgeid % 3 == 1) {
+    double theta = (j + 1) * 2 * M_PI / n - M_PI / 2;
+    return std::make_shared<LineBorder>(i * cos(theta), i * sin(theta),
+                                        (i + 1) * cos(theta),
+                                        (i + 1) * sin(theta));
   }
+  return std::make_shared<ArcBorder>(0, 0, edgeid % 3 == 0 ? i : size_,
+                                     j * 2 * M_PI / n - M_PI / 2,
+                                     (j + 1) * 2 * M_PI / n - M_PI / 2);
 }
 
 std::tuple<double, double, double, double> CircularMaze::GetCoordinateBounds()
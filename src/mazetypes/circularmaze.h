@@ -3,15 +3,39 @@
 
 #include "maze.h"
 
+// Concentric rings of cells, with the number of cells doubling whenever they
+// grow too wide. Every node owns the arc towards the inner ring (0), the line
+// towards the next node of its ring (1) and, on the outermost ring, the outer
+// arc (2).
+class CircularGraph : public Graph {
+ public:
+  CircularGraph(int);
+  int RingNodeCount(int ring) const { return ringnodecount_[ring]; }
+  int RingNodePrefixSum(int ring) const { return ringnodeprefixsum_[ring]; }
+  std::pair<int, int> NodeCoordinates(int) const;
+  int Vertices() const;
+  int Edges() const;
+  int MaxDegree() const;
+  int Neighbors(int, int*, int*) const;
+
+ private:
+  int size_;
+  std::vector<int> ringnodecount_, ringnodeprefixsum_;
+};
+
 class CircularMaze : public Maze {
  public:
   CircularMaze(int);
+  std::unique_ptr<Maze> Clone() const {
+    return std::make_unique<CircularMaze>(*this);
+  }
   virtual void InitialiseGraph();
 
  protected:
   int size_;
-  std::vector<int> ringnodecount_, ringnodeprefixsum_;
+  std::shared_ptr<const CircularGraph> lattice_;
 
+  virtual std::shared_ptr<CellBorder> GetBorder(int) const;
   std::tuple<double, double, double, double> GetCoordinateBounds() const;
 };
 
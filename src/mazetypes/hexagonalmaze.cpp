@@ -2,73 +2,102 @@
 #include <cmath>
 #include <iostream>
 
-HexagonalMaze::HexagonalMaze(int size) : Maze(6 * size * size), size_(size) {
-  startvertex_ = VertexIndex(0, 1, size_ - 1, 0);
-  endvertex_ = VertexIndex(3, 1, size_ - 1, 0);
+HexagonalGraph::HexagonalGraph(int size) : size_(size) {}
+
+int HexagonalGraph::VertexIndex(int sector, int updown, int row,
+                                int column) const {
+  int vertexindex = sector * size_ * size_;
+  if (updown == 1) vertexindex += (size_ * (size_ + 1)) / 2;
+  vertexindex += (row * (row + 1)) / 2 + column;
+
+  return vertexindex;
 }
 
-void HexagonalMaze::InitialiseGraph() {
-  Maze::InitialiseGraph();
+std::tuple<int, int, int, int> HexagonalGraph::VertexCoordinates(
+    int vertex) const {
+  int sector = vertex / (size_ * size_), index = vertex % (size_ * size_);
+  int updown = index >= (size_ * (size_ + 1)) / 2;
+  if (updown == 1) index -= (size_ * (size_ + 1)) / 2;
+
+  // Largest row with row*(row+1)/2 <= index
+  int row = (std::sqrt(8.0 * index + 1) - 1) / 2;
+  while ((row * (row + 1)) / 2 > index) --row;
+  while (((row + 1) * (row + 2)) / 2 <= index) ++row;
+  return std::make_tuple(sector, updown, row, index - (row * (row + 1)) / 2);
+}
 
-  // Hexagon can be split into 6 triangular sectors
-  // Each of which is subdivided into size_*size triangles
+int HexagonalGraph::EdgeId(int sector, int row, int column, int edge) const {
+  // All edges are owned by the up triangle they border
+  return 3 * VertexIndex(sector, 0, row, column) + edge;
+}
 
-  for (int sector = 0; sector < 6; ++sector) {
-    // Outer boundary, except entry and exit
-    for (int i = 0; i < size_; ++i) {
-      if ((i > 0) or (sector % 3 != 0)) {
-        std::shared_ptr<CellBorder> ptr =
-            this->GetEdge(sector, size_ - 1, i, 0);
-        adjacencylist_[VertexIndex(sector, 0, size_ - 1, i)].push_back(
-            {-1, ptr});
-      }
-    }
+int HexagonalGraph::Vertices() const { return 6 * size_ * size_; }
 
-    // Border between the 6 major triangles
-    for (int i = 0; i < size_; ++i) {
-      std::shared_ptr<CellBorder> ptr = this->GetEdge(sector, i, i, 1);
-      adjacencylist_[VertexIndex(sector, 0, i, i)].push_back(
-          {VertexIndex((sector + 1) % 6, 0, i, 0), ptr});
-      adjacencylist_[VertexIndex((sector + 1) % 6, 0, i, 0)].push_back(
-          {VertexIndex(sector, 0, i, i), ptr});
-    }
+int HexagonalGraph::Edges() const { return 3 * Vertices(); }
 
-    // 0-type edge
-    // Between up vertex (i,j) and down vertex (i,j)
-    for (int i = 0; i < size_ - 1; ++i) {
-      for (int j = 0; j <= i; ++j) {
-        std::shared_ptr<CellBorder> ptr = this->GetEdge(sector, i, j, 0);
-        adjacencylist_[VertexIndex(sector, 0, i, j)].push_back(
-            {VertexIndex(sector, 1, i, j), ptr});
-        adjacencylist_[VertexIndex(sector, 1, i, j)].push_back(
-            {VertexIndex(sector, 0, i, j), ptr});
-      }
-    }
+int HexagonalGraph::MaxDegree() const { return 3; }
 
-    // 1-type edge
-    // Between up vertex (i,j) and down vertex (i-1,j)
-    for (int i = 0; i < size_; ++i) {
-      for (int j = 0; j < i; ++j) {
-        std::shared_ptr<CellBorder> ptr = this->GetEdge(sector, i, j, 1);
-        adjacencylist_[VertexIndex(sector, 0, i, j)].push_back(
-            {VertexIndex(sector, 1, i - 1, j), ptr});
-        adjacencylist_[VertexIndex(sector, 1, i - 1, j)].push_back(
-            {VertexIndex(sector, 0, i, j), ptr});
-      }
-    }
+int HexagonalGraph::Neighbors(int vertex, int* neighbors,
+                              int* edgeids) const {
+  auto [sector, updown, row, column] = VertexCoordinates(vertex);
+  int degree = 0;
+  auto add = [&](int neighbor, int edgeid) {
+    neighbors[degree] = neighbor;
+    edgeids[degree++] = edgeid;
+  };
 
-    // 2-type edge
-    // Between up vertex (i,j) and down vertex (i-1,j-1)
+  if (updown == 1) {
+    // Down vertex (i,j) borders up vertices (i,j), (i+1,j) and (i+1,j+1)
+    add(VertexIndex(sector, 0, row, column), EdgeId(sector, row, column, 0));
+    add(VertexIndex(sector, 0, row + 1, column),
+        EdgeId(sector, row + 1, column, 1));
+    add(VertexIndex(sector, 0, row + 1, column + 1),
+        EdgeId(sector, row + 1, column + 1, 2));
+    return degree;
+  }
+
+  // 0-type edge to down vertex (i,j), the outer row borders the boundary
+  if (row < size_ - 1)
+    add(VertexIndex(sector, 1, row, column), EdgeId(sector, row, column, 0));
+
+  // 1-type edge to down vertex (i-1,j), or the border with the next sector
+  if (column < row)
+    add(VertexIndex(sector, 1, row - 1, column),
+        EdgeId(sector, row, column, 1));
+  else
+    add(VertexIndex((sector + 1) % 6, 0, row, 0),
+        EdgeId(sector, row, column, 1));
+
+  // 2-type edge to down vertex (i-1,j-1), or the border with the previous
+  // sector, which that sector owns
+  if (column > 0)
+    add(VertexIndex(sector, 1, row - 1, column - 1),
+        EdgeId(sector, row, column, 2));
+  else
+    add(VertexIndex((sector + 5) % 6, 0, row, row),
+        EdgeId((sector + 5) % 6, row, row, 1));
+  return degree;
+}
+
+HexagonalMaze::HexagonalMaze(int size) : Maze(6 * size * size), size_(size) {
+  lattice_ = std::make_shared<HexagonalGraph>(size);
+  startvertex_ = lattice_->VertexIndex(0, 1, size_ - 1, 0);
+  endvertex_ = lattice_->VertexIndex(3, 1, size_ - 1, 0);
+}
+
+void HexagonalMaze::InitialiseGraph() {
+  Maze::InitialiseGraph();
+  graph_ = lattice_;
+
+  // Outer boundary, except entry and exit
+  for (int sector = 0; sector < 6; ++sector) {
     for (int i = 0; i < size_; ++i) {
-      for (int j = 1; j <= i; ++j) {
-        std::shared_ptr<CellBorder> ptr = this->GetEdge(sector, i, j, 2);
-        adjacencylist_[VertexIndex(sector, 0, i, j)].push_back(
-            {VertexIndex(sector, 1, i - 1, j - 1), ptr});
-        adjacencylist_[VertexIndex(sector, 1, i - 1, j - 1)].push_back(
-            {VertexIndex(sector, 0, i, j), ptr});
-      }
+      if ((i > 0) or (sector % 3 != 0))
+        AddBoundary(lattice_->EdgeId(sector, size_ - 1, i, 0));
     }
   }
+
+  FinaliseGraph();
 }
 
 std::shared_ptr<CellBorder> HexagonalMaze::GetEdge(int sector, int row,
@@ -109,13 +138,9 @@ std::shared_ptr<CellBorder> HexagonalMaze::GetEdge(int sector, int row,
       ex2 * costheta - ey2 * sintheta, ex2 * sintheta + ey2 * costheta);
 }
 
-int HexagonalMaze::VertexIndex(int sector, int updown, int row,
-                               int column) const {
-  int vertexindex = sector * size_ * size_;
-  if (updown == 1) vertexindex += (size_ * (size_ + 1)) / 2;
-  vertexindex += (row * (row + 1)) / 2 + column;
-
-  return vertexindex;
+std::shared_ptr<CellBorder> HexagonalMaze::GetBorder(int edgeid) const {
+  auto [sector, updown, row, column] = lattice_->VertexCoordinates(edgeid / 3);
+  return this->GetEdge(sector, row, column, edgeid % 3);
 }
 
 std::tuple<double, double, double, double> HexagonalMaze::GetCoordinateBounds()
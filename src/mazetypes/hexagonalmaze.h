@@ -3,16 +3,38 @@
 
 #include "maze.h"
 
+// Hexagon split into 6 triangular sectors, each of which is subdivided into
+// size*size up and down triangles. All edges are owned by the up triangle
+// they border, as 3 * vertex + edge type.
+class HexagonalGraph : public Graph {
+ public:
+  HexagonalGraph(int);
+  int VertexIndex(int, int, int, int) const;
+  std::tuple<int, int, int, int> VertexCoordinates(int) const;
+  int EdgeId(int, int, int, int) const;
+  int Vertices() const;
+  int Edges() const;
+  int MaxDegree() const;
+  int Neighbors(int, int*, int*) const;
+
+ private:
+  int size_;
+};
+
 class HexagonalMaze : public Maze {
  public:
   HexagonalMaze(int);
+  std::unique_ptr<Maze> Clone() const {
+    return std::make_unique<HexagonalMaze>(*this);
+  }
   virtual void InitialiseGraph();
 
  protected:
   int size_;
+  std::shared_ptr<const HexagonalGraph> lattice_;
 
   virtual std::shared_ptr<CellBorder> GetEdge(int, int, int, int) const;
-  int VertexIndex(int, int, int, int) const;
+  virtual std::shared_ptr<CellBorder> GetBorder(int) const;
   std::tuple<double, double, double, double> GetCoordinateBounds() const;
 };
 
@@ -1,46 +1,106 @@
 #include "honeycombmaze.h"
 #include <cmath>
 
-const int HoneyCombMaze::neigh[6][2] = {{-1, 0}, {-1, 1}, {0, 1},
-                                        {1, 0},  {1, -1}, {0, -1}};
+const int HoneyCombGraph::neigh[6][2] = {{-1, 0}, {-1, 1}, {0, 1},
+                                         {1, 0},  {1, -1}, {0, -1}};
+
+HoneyCombGraph::HoneyCombGraph(int size) : size_(size) {}
+
+// u, v are diretions up and right-down
+int HoneyCombGraph::VertexIndex(int u, int v) const {
+  if (u <= 0)
+    return ((3 * size_ + u) * (size_ + u - 1)) / 2 + v;
+  else
+    return (3 * size_ * (size_ - 1) + (4 * size_ - u - 1) * u) / 2 + v;
+}
+
+std::pair<int, int> HoneyCombGraph::CellCoordinates(int node) const {
+  // The numbering is point symmetric, so the lower half mirrors the upper
+  int vertices = Vertices();
+  if (2 * node >= vertices) {
+    auto [u, v] = CellCoordinates(vertices - 1 - node);
+    return {-u, -v};
+  }
+
+  // Row t = u + size - 1 holds size + t cells and starts at
+  // t * size + t * (t - 1) / 2, invert the quadratic for t
+  auto rowstart = [this](int t) { return t * size_ + (t * (t - 1)) / 2; };
+  int t = (-(2 * size_ - 1) +
+           std::sqrt((2.0 * size_ - 1) * (2 * size_ - 1) + 8.0 * node)) /
+          2;
+  while (rowstart(t) > node) --t;
+  while (rowstart(t + 1) <= node) ++t;
+  int u = t - size_ + 1;
+  return {u, VExtent(u).first + node - rowstart(t)};
+}
+
+std::pair<int, int> HoneyCombGraph::VExtent(int u) const {
+  if (u < 0)
+    return {-size_ - u + 1, size_ - 1};
+  else
+    return {-size_ + 1, size_ - 1 - u};
+}
+
+bool HoneyCombGraph::IsValidNode(int u, int v) const {
+  if (u <= -size_ or u >= size_) return false;
+  auto vextent = VExtent(u);
+  return v >= vextent.first and v <= vextent.second;
+}
+
+int HoneyCombGraph::Vertices() const { return 3 * size_ * (size_ - 1) + 1; }
+
+int HoneyCombGraph::Edges() const { return 6 * Vertices(); }
+
+int HoneyCombGraph::MaxDegree() const { return 6; }
+
+int HoneyCombGraph::Neighbors(int node, int* neighbors, int* edgeids) const {
+  auto [u, v] = CellCoordinates(node);
+  int degree = 0;
+  for (int n = 0; n < 6; ++n) {
+    int uu = u + neigh[n][0], vv = v + neigh[n][1];
+    if (!IsValidNode(uu, vv)) continue;
+    int nnode = VertexIndex(uu, vv);
+    neighbors[degree] = nnode;
+    // Opposite direction of n is (n + 3) % 6
+    edgeids[degree++] = nnode < node ? 6 * node + n : 6 * nnode + (n + 3) % 6;
+  }
+  return degree;
+}
 
 HoneyCombMaze::HoneyCombMaze(int size)
-    : Maze(3 * size * (size - 1) + 1, 0, 3 * size * (size - 1)), size_(size) {}
+    : Maze(3 * size * (size - 1) + 1, 0, 3 * size * (size - 1)), size_(size) {
+  lattice_ = std::make_shared<HoneyCombGraph>(size);
+}
 
 void HoneyCombMaze::InitialiseGraph() {
   Maze::InitialiseGraph();
+  graph_ = lattice_;
 
+  // Outer boundary, except entry and exit
   for (int u = -size_ + 1; u < size_; ++u) {
-    auto vextent = VExtent(u);
+    auto vextent = lattice_->VExtent(u);
     for (int v = vextent.first; v <= vextent.second; ++v) {
-      int node = VertexIndex(u, v);
+      int node = lattice_->VertexIndex(u, v);
       for (int n = 0; n < 6; ++n) {
-        int uu = u + neigh[n][0], vv = v + neigh[n][1];
-        if (IsValidNode(uu, vv)) {
-          int nnode = VertexIndex(uu, vv);
-          if (nnode > node) continue;
-          std::shared_ptr<LineBorder> ptr =
-              std::make_shared<LineBorder>(GetEdge(u, v, n));
-          adjacencylist_[node].push_back({nnode, ptr});
-          adjacencylist_[nnode].push_back({node, ptr});
-        } else {
-          if ((node == startvertex_ and n == 0) or
-              (node == endvertex_ and n == 3))
-            continue;
-          adjacencylist_[node].push_back(
-              {-1, std::make_shared<LineBorder>(GetEdge(u, v, n))});
-        }
+        int uu = u + HoneyCombGraph::neigh[n][0],
+            vv = v + HoneyCombGraph::neigh[n][1];
+        if (lattice_->IsValidNode(uu, vv)) continue;
+        if ((node == startvertex_ and n == 0) or
+            (node == endvertex_ and n == 3))
+          continue;
+        AddBoundary(6 * node + n);
       }
     }
   }
+
+  FinaliseGraph();
 }
 
-// u, v are diretions up and right-down
-int HoneyCombMaze::VertexIndex(int u, int v) const {
-  if (u <= 0)
-    return ((3 * size_ + u) * (size_ + u - 1)) / 2 + v;
-  else
-    return (3 * size_ * (size_ - 1) + (4 * size_ - u - 1) * u) / 2 + v;
+std::shared_ptr<CellBorder> HoneyCombMaze::GetBorder(int edgeid) const {
+  // Edges are owned by the higher numbered cell, as edge edgeid % 6 of cell
+  // edgeid / 6
+  auto [u, v] = lattice_->CellCoordinates(edgeid / 6);
+  return std::make_shared<LineBorder>(GetEdge(u, v, edgeid % 6));
 }
 
 std::tuple<double, double, double, double> HoneyCombMaze::GetEdge(
@@ -58,16 +118,3 @@ std::tuple<double, double, double, double> HoneyCombMaze::GetCoordinateBounds()
   double xlim = sqrt(3) * (size_ - 0.5), ylim = 1.5 * size_ - 0.5;
   return std::make_tuple(-xlim, -ylim, xlim, ylim);
 }
-
-std::pair<int, int> HoneyCombMaze::VExtent(int u) {
-  if (u < 0)
-    return {-size_ - u + 1, size_ - 1};
-  else
-    return {-size_ + 1, size_ - 1 - u};
-}
-
-bool HoneyCombMaze::IsValidNode(int u, int v) {
-  if (u <= -size_ or u >= size_) return false;
-  auto vextent = VExtent(u);
-  return v >= vextent.first and v <= vextent.second;
-}
@@ -3,20 +3,41 @@
 
 #include "maze.h"
 
+// Hexagonal cells addressed by axial coordinates u (up) and v (right-down).
+// Each edge is owned by the higher numbered cell, as 6 * cell + direction.
+class HoneyCombGraph : public Graph {
+ public:
+  HoneyCombGraph(int);
+  int VertexIndex(int, int) const;
+  std::pair<int, int> CellCoordinates(int) const;
+  std::pair<int, int> VExtent(int) const;
+  bool IsValidNode(int, int) const;
+  int Vertices() const;
+  int Edges() const;
+  int MaxDegree() const;
+  int Neighbors(int, int*, int*) const;
+
+  static const int neigh[6][2];
+
+ private:
+  int size_;
+};
+
 class HoneyCombMaze : public Maze {
  public:
   HoneyCombMaze(int);
+  std::unique_ptr<Maze> Clone() const {
+    return std::make_unique<HoneyCombMaze>(*this);
+  }
   void InitialiseGraph();
 
  protected:
   int size_;
-  static const int neigh[6][2];
+  std::shared_ptr<const HoneyCombGraph> lattice_;
 
-  int VertexIndex(int, int) const;
   virtual std::tuple<double, double, double, double> GetEdge(int, int,
                                                              int) const;
-  std::pair<int, int> VExtent(int);
-  bool IsValidNode(int, int);
+  virtual std::shared_ptr<CellBorder> GetBorder(int) const;
   virtual std::tuple<double, double, double, double> GetCoordinateBounds()
       const;
 };
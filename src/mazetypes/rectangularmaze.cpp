@@ -1,57 +1,156 @@
 #include "rectangularmaze.h"
+#include <algorithm>
+
+RectangularGraph::RectangularGraph(int width, int height)
+    : width_(width), height_(height) {}
+
+int RectangularGraph::Vertices() const { return width_ * height_; }
+
+int RectangularGraph::Edges() const { return 4 * width_ * height_; }
+
+int RectangularGraph::MaxDegree() const { return 4; }
+
+int RectangularGraph::Neighbors(int vertex, int* neighbors,
+                                int* edgeids) const {
+  int row = vertex / width_, column = vertex % width_, degree = 0;
+  auto add = [&](int neighbor, int edgeid) {
+    neighbors[degree] = neighbor;
+    edgeids[degree++] = edgeid;
+  };
+
+  if (column + 1 < width_) add(vertex + 1, 4 * vertex);
+  if (row + 1 < height_) add(vertex + width_, 4 * vertex + 1);
+  if (column > 0) add(vertex - 1, 4 * (vertex - 1));
+  if (row > 0) add(vertex - width_, 4 * (vertex - width_) + 1);
+  return degree;
+}
 
 RectangularMaze::RectangularMaze(int width, int height)
     : Maze(width * height, 0, width * height - 1),
       width_(width),
       height_(height) {}
 
-int RectangularMaze::VertexIndex(int row, int column) {
-  return row * width_ + column;
-}
-
 void RectangularMaze::InitialiseGraph() {
   Maze::InitialiseGraph();
+  graph_ = std::make_shared<RectangularGraph>(width_, height_);
 
   // Lower and upper boundaries
   for (int i = 0; i < width_; ++i) {
-    adjacencylist_[VertexIndex(0, i)].push_back(
-        {-1, std::make_shared<LineBorder>(i, 0, i + 1, 0)});
-    adjacencylist_[VertexIndex(height_ - 1, i)].push_back(
-        {-1, std::make_shared<LineBorder>(i, height_, i + 1, height_)});
+    AddBoundary(4 * i + 3);
+    AddBoundary(4 * ((height_ - 1) * width_ + i) + 1);
   }
 
   // Left and right boundaries, leaving space for entry and exit
   for (int i = 0; i < height_; ++i) {
-    if (i != 0)
-      adjacencylist_[VertexIndex(i, 0)].push_back(
-          {-1, std::make_shared<LineBorder>(0, i, 0, i + 1)});
-    if (i != height_ - 1)
-      adjacencylist_[VertexIndex(i, 0)].push_back(
-          {-1, std::make_shared<LineBorder>(width_, i, width_, i + 1)});
+    if (i != 0) AddBoundary(4 * i * width_ + 2);
+    if (i != height_ - 1) AddBoundary(4 * ((i + 1) * width_ - 1));
   }
 
-  // Horizontally adjacent cells
-  for (int i = 0; i < height_; ++i) {
-    for (int j = 0; j < width_ - 1; ++j) {
-      std::shared_ptr<LineBorder> ptr =
-          std::make_shared<LineBorder>(j + 1, i, j + 1, i + 1);
-      adjacencylist_[VertexIndex(i, j)].push_back({VertexIndex(i, j + 1), ptr});
-      adjacencylist_[VertexIndex(i, j + 1)].push_back({VertexIndex(i, j), ptr});
-    }
-  }
+  FinaliseGraph();
+}
 
-  // Vertically adjacent cells
-  for (int i = 0; i < height_ - 1; ++i) {
-    for (int j = 0; j < width_; ++j) {
-      std::shared_ptr<LineBorder> ptr =
-          std::make_shared<LineBorder>(j, i + 1, j + 1, i + 1);
-      adjacencylist_[VertexIndex(i, j)].push_back({VertexIndex(i + 1, j), ptr});
-      adjacencylist_[VertexIndex(i + 1, j)].push_back({VertexIndex(i, j), ptr});
-    }
-  }
+std::shared_ptr<CellBorder> RectangularMaze::GetBorder(int edgeid) const {
+  int ends[4];
+  WallEnds(edgeid, ends);
+  return std::make_shared<LineBorder>(ends[0], ends[1], ends[2], ends[3]);
+}
+
+void RectangularMaze::PrintWall(MazeWriter& writer, int edgeid) const {
+  int ends[4];
+  WallEnds(edgeid, ends);
+  writer.Line(ends[0], ends[1], ends[2], ends[3]);
+}
+
+void RectangularMaze::WallEnds(int edgeid, int ends[4]) const {
+  // Endpoint offsets of the right, top, left and bottom walls of a cell
+  static const int offsets[4][4] = {
+      {1, 0, 1, 1}, {0, 1, 1, 1}, {0, 0, 0, 1}, {0, 0, 1, 0}};
+  int row = edgeid / 4 / width_, column = edgeid / 4 % width_;
+  const int* offset = offsets[edgeid % 4];
+  ends[0] = column + offset[0];
+  ends[1] = row + offset[1];
+  ends[2] = column + offset[2];
+  ends[3] = row + offset[3];
 }
 
 std::tuple<double, double, double, double>
 RectangularMaze::GetCoordinateBounds() const {
   return std::make_tuple(0, 0, width_, height_);
 }
+
+TiledSpanningTree::TiledSpanningTree(int width, int height, int tilesize,
+                                     Factory factory)
+    : width_(width),
+      height_(height),
+      tilesize_(tilesize),
+      factory_(std::move(factory)) {}
+
+void TiledSpanningTree::SpanningTree(int, const Graph&, EdgeSink& sink) {
+  int columns = (width_ + tilesize_ - 1) / tilesize_,
+      rows = (height_ + tilesize_ - 1) / tilesize_, tiles = columns * rows;
+
+  // Renumbers the edges of a tile as edges of the whole maze
+  class Renumberer : public EdgeSink {
+   public:
+    Renumberer(EdgeSink& sink, int width, int offset, int stride)
+        : sink_(sink), width_(width), offset_(offset), stride_(stride) {}
+    void AddEdge(int u, int v, int edgeid) {
+      sink_.AddEdge(Vertex(u), Vertex(v), 4 * Vertex(edgeid / 4) + edgeid % 4);
+    }
+
+   private:
+    EdgeSink& sink_;
+    int width_, offset_, stride_;
+
+    int Vertex(int v) const {
+      return offset_ + v / width_ * stride_ + v % width_;
+    }
+  };
+
+  // Every tile has its own seed, so the tree does not depend on the number
+  // of threads
+  uint64_t seed = generator();
+  if (int(algorithms_.size()) < EdgeSlots()) algorithms_.resize(EdgeSlots());
+  for (auto& algorithm : algorithms_) {
+    if (!algorithm) algorithm = factory_();
+  }
+  ParallelEdges(tiles, [&](int tile, EdgeSink& tilesink) {
+    int column = tile % columns * tilesize_, row = tile / columns * tilesize_;
+    int width = std::min(tilesize_, width_ - column),
+        height = std::min(tilesize_, height_ - row);
+    Renumberer renumberer(tilesink, width, row * width_ + column, width_);
+    auto& algorithm = algorithms_[tile % EdgeSlots()];
+    algorithm->Seed(seed + tile);
+    algorithm->SpanningTree(width * height, RectangularGraph(width, height),
+                            renumberer);
+  }, sink);
+
+  // A passage at a random position along each seam of a tree of the tiles
+  class SeamList : public EdgeSink {
+   public:
+    explicit SeamList(std::vector<int>& seams) : seams_(seams) {}
+    void AddEdge(int, int, int edgeid) { seams_.push_back(edgeid); }
+
+   private:
+    std::vector<int>& seams_;
+  } seamlist(seams_);
+  if (!seamalgorithm_) seamalgorithm_ = factory_();
+  seamalgorithm_->Seed(generator());
+  seams_.clear();
+  seamalgorithm_->SpanningTree(tiles, RectangularGraph(columns, rows),
+                               seamlist);
+  for (int seam : seams_) {
+    int tile = seam / 4;
+    int column = tile % columns * tilesize_, row = tile / columns * tilesize_;
+    if (seam % 4 == 0) {
+      row += RandomIndex(std::min(tilesize_, height_ - row));
+      column += tilesize_ - 1;
+    } else {
+      column += RandomIndex(std::min(tilesize_, width_ - column));
+      row += tilesize_ - 1;
+    }
+    int vertex = row * width_ + column;
+    sink.AddEdge(vertex, vertex + (seam % 4 == 0 ? 1 : width_),
+                 4 * vertex + seam % 4);
+  }
+}
@@ -1,14 +1,70 @@
 #include "maze.h"
+#include <climits>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Cell (row, column) is vertex row * width + column, and owns the edges
+// 4 * vertex + direction to its right, top, left and bottom. Interior walls
+// belong to the cell on their left or bottom.
+class RectangularGraph : public Graph, public Lattice {
+ public:
+  RectangularGraph(int, int);
+  int Vertices() const;
+  int Edges() const;
+  int MaxDegree() const;
+  int Neighbors(int, int*, int*) const;
+  int Rows() const { return height_; }
+  int Columns(int) const { return width_; }
+  int Vertex(int row, int column) const { return row * width_ + column; }
+
+  // Edge ids 4 * vertex + direction are ints, which bounds the cells
+  static const int maxcells = INT_MAX / 4;
+  static bool Fits(int width, int height) {
+    return static_cast<long long>(width) * height <= maxcells;
+  }
+
+ private:
+  int width_, height_;
+};
+
+// Spanning trees of a RectangularGraph of the given width and height, built
+// from square tiles. The tiles are carved in parallel, each by its own
+// instance of another algorithm, and joined through one random passage
+// across every seam of a spanning tree of the tiles. The tiles stay small
+// enough for the state of their algorithm to fit in cache.
+class TiledSpanningTree : public SpanningtreeAlgorithm {
+ public:
+  using Factory = std::function<std::unique_ptr<SpanningtreeAlgorithm>()>;
+  TiledSpanningTree(int, int, int, Factory);
+  void SpanningTree(int, const Graph&, EdgeSink&);
+
+ private:
+  int width_, height_, tilesize_;
+  Factory factory_;
+  // Algorithm of every slot of ParallelEdges for the tiles, and the one for
+  // the tree of tiles with its seams. They keep their buffers between trees.
+  std::vector<std::unique_ptr<SpanningtreeAlgorithm>> algorithms_;
+  std::unique_ptr<SpanningtreeAlgorithm> seamalgorithm_;
+  std::vector<int> seams_;
+};
 
 class RectangularMaze : public Maze {
  public:
   RectangularMaze(int, int);
+  std::unique_ptr<Maze> Clone() const {
+    return std::make_unique<RectangularMaze>(*this);
+  }
   virtual void InitialiseGraph();
 
  private:
   int width_, height_;
 
-  int VertexIndex(int, int);
+  virtual std::shared_ptr<CellBorder> GetBorder(int) const;
+  // Walls have integer coordinates, written without a border
+  virtual void PrintWall(MazeWriter&, int) const;
+  // Endpoints x1, y1, x2, y2 of the wall of an edge
+  void WallEnds(int, int[4]) const;
   virtual std::tuple<double, double, double, double> GetCoordinateBounds()
       const;
 };
@@ -0,0 +1,97 @@
+#include "streamedmaze.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "rectangularmaze.h"
+
+StreamedMaze::StreamedMaze(int width, int height)
+    : width_(width), height_(height) {}
+
+void StreamedMaze::PrintMazeGnuplot(const std::string& outputprefix,
+                                    SpanningtreeAlgorithm* algorithm) {
+  GnuplotWriter writer(outputprefix, std::make_tuple(0, 0, width_, height_));
+  Generate(algorithm, writer);
+}
+
+void StreamedMaze::PrintMazeSVG(const std::string& outputprefix,
+                                SpanningtreeAlgorithm* algorithm) {
+  SVGWriter writer(outputprefix, std::make_tuple(0, 0, width_, height_));
+  Generate(algorithm, writer);
+}
+
+void StreamedMaze::Generate(SpanningtreeAlgorithm* algorithm,
+                            MazeWriter& writer) {
+  bool fits = RectangularGraph::Fits(width_, height_);
+  if (!fits and !algorithm->PassesRows()) {
+    throw std::invalid_argument(
+        "Rectangular maze of size " + std::to_string(width_) + "x" +
+        std::to_string(height_) + " has more than " +
+        std::to_string(RectangularGraph::maxcells) +
+        " cells, only algorithms passing rows stream larger ones");
+  }
+
+  // Gathers the passages to the left of and below the cells of a row, and
+  // writes its walls once the algorithm has moved on to the next row
+  class RowWriter : public RowSink {
+   public:
+    RowWriter(int width, int height, MazeWriter& writer)
+        : width_(width),
+          height_(height),
+          row_(0),
+          left_(width, 0),
+          down_(width, 0),
+          writer_(writer) {}
+
+    void AddEdge(int, int, int edgeid) {
+      int cell = edgeid / 4;
+      AddPassage(cell / width_, cell % width_, edgeid % 4 == 1);
+    }
+
+    // A passage belongs to the row of its upper or right cell
+    void AddPassage(int row, int column, bool up) {
+      if (up) ++row;
+      if (row < row_) throw std::logic_error("Edges out of row order");
+      while (row_ < row) Flush();
+      if (up)
+        down_[column] = 1;
+      else
+        left_[column + 1] = 1;
+    }
+
+    void Flush() {
+      // Entry on the left of the first row and exit on the right of the last
+      if (row_ != 0) Wall(0, row_, 0, row_ + 1);
+      if (row_ != height_ - 1) Wall(width_, row_, width_, row_ + 1);
+      for (int column = 1; column < width_; ++column) {
+        if (!left_[column]) Wall(column, row_, column, row_ + 1);
+      }
+      for (int column = 0; column < width_; ++column) {
+        if (!down_[column]) Wall(column, row_, column + 1, row_);
+      }
+      std::fill(left_.begin(), left_.end(), 0);
+      std::fill(down_.begin(), down_.end(), 0);
+      ++row_;
+    }
+
+    void Finish() {
+      while (row_ < height_) Flush();
+      for (int column = 0; column < width_; ++column)
+        Wall(column, height_, column + 1, height_);
+    }
+
+   private:
+    int width_, height_, row_;
+    std::vector<char> left_, down_;
+    MazeWriter& writer_;
+
+    void Wall(double x1, double y1, double x2, double y2) {
+      writer_.Line(x1, y1, x2, y2);
+    }
+  } rowwriter(width_, height_, writer);
+
+  // The graph only computes neighbors on demand, it takes no memory.
+  // Algorithms passing rows ignore the vertex count, which may not fit.
+  algorithm->SpanningTree(fits ? width_ * height_ : 0,
+                          RectangularGraph(width_, height_), rowwriter);
+  rowwriter.Finish();
+}
@@ -0,0 +1,28 @@
+#ifndef STREAMEDMAZE_H
+#define STREAMEDMAZE_H
+
+#include "mazewriter.h"
+#include "spanningtreealgorithm.h"
+#include <string>
+
+// Rectangular maze written while it is generated, by algorithms which pass
+// all the edges of a row before those of the rows above, like Eller's
+// algorithm, binary tree and sidewinder. An edge belongs to the row of its
+// upper or right cell. Only the passages of the current row are kept, so
+// memory depends on the width only. The maze is never held as a graph, so
+// it cannot be solved. Algorithms which pass rows, like Eller's algorithm,
+// stream mazes of any size, the others throw std::invalid_argument beyond
+// RectangularGraph::maxcells.
+class StreamedMaze {
+ public:
+  StreamedMaze(int, int);
+  void PrintMazeGnuplot(const std::string&, SpanningtreeAlgorithm*);
+  void PrintMazeSVG(const std::string&, SpanningtreeAlgorithm*);
+  // Writes the walls of every row, in the same places as RectangularMaze
+  void Generate(SpanningtreeAlgorithm*, MazeWriter&);
+
+ private:
+  int width_, height_;
+};
+
+#endif /* end of include guard: STREAMEDMAZE_H */
@@ -1,101 +1,109 @@
 #include "triangularmaze.h"
+#include <cmath>
 
-TriangularMaze::TriangularMaze(int rows) : rows_(rows) {
-  // Calculate total vertices: row 0 has rows cells, row 1 has rows-1 cells, etc.
-  // Total = rows + (rows-1) + ... + 1 = rows*(rows+1)/2
-  vertices_ = rows * (rows + 1) / 2;
-  adjacencylist_.resize(vertices_);
-  
-  // Start at top-left, end at bottom-right
-  startvertex_ = 0;
-  endvertex_ = vertices_ - 1;
-}
+TriangularGraph::TriangularGraph(int rows) : rows_(rows) {}
 
-int TriangularMaze::CellsInRow(int row) const {
+int TriangularGraph::CellsInRow(int row) const {
   return rows_ - row;  // Top row has most cells, bottom row has 1 cell
 }
 
-int TriangularMaze::CellsBeforeRow(int row) const {
+int TriangularGraph::CellsBeforeRow(int row) const {
   // Sum of (rows) + (rows-1) + ... + (rows-row+1)
-  int total = 0;
-  for (int r = 0; r < row; r++) {
-    total += CellsInRow(r);
-  }
-  return total;
+  return row * (2 * rows_ - row + 1) / 2;
 }
 
-int TriangularMaze::VertexIndex(int row, int col) const {
+int TriangularGraph::VertexIndex(int row, int col) const {
   return CellsBeforeRow(row) + col;
 }
 
+std::pair<int, int> TriangularGraph::CellCoordinates(int vertex) const {
+  // Largest row with CellsBeforeRow(row) = row*(2*rows-row+1)/2 <= vertex
+  double b = 2 * rows_ + 1;
+  int row = (b - std::sqrt(b * b - 8.0 * vertex)) / 2;
+  while (row > 0 and CellsBeforeRow(row) > vertex) --row;
+  while (row + 1 < rows_ and CellsBeforeRow(row + 1) <= vertex) ++row;
+  return {row, vertex - CellsBeforeRow(row)};
+}
+
+int TriangularGraph::Vertices() const { return rows_ * (rows_ + 1) / 2; }
+
+int TriangularGraph::Edges() const { return 4 * Vertices(); }
+
+int TriangularGraph::MaxDegree() const { return 4; }
+
+int TriangularGraph::Neighbors(int vertex, int* neighbors,
+                               int* edgeids) const {
+  auto [row, col] = CellCoordinates(vertex);
+  int cells_in_row = CellsInRow(row), degree = 0;
+  auto add = [&](int neighbor, int edgeid) {
+    neighbors[degree] = neighbor;
+    edgeids[degree++] = edgeid;
+  };
+
+  if (col + 1 < cells_in_row) {
+    add(vertex + 1, 4 * vertex);
+    add(vertex + cells_in_row, 4 * vertex + 1);
+  }
+  if (col > 0) add(vertex - 1, 4 * (vertex - 1));
+  if (row > 0)
+    add(vertex - cells_in_row - 1, 4 * (vertex - cells_in_row - 1) + 1);
+  return degree;
+}
+
+TriangularMaze::TriangularMaze(int rows) : rows_(rows) {
+  lattice_ = std::make_shared<TriangularGraph>(rows);
+  vertices_ = lattice_->Vertices();
+
+  // Start at top-left, end at bottom-right
+  startvertex_ = 0;
+  endvertex_ = vertices_ - 1;
+}
+
 void TriangularMaze::InitialiseGraph() {
   Maze::InitialiseGraph();
+  graph_ = lattice_;
 
-  // Add boundary walls - exactly like rectangular maze but adjust for triangle
-  
-  // Top boundary
-  for (int i = 0; i < CellsInRow(0); ++i) {
-    adjacencylist_[VertexIndex(0, i)].push_back(
-        {-1, std::make_shared<LineBorder>(i, 0, i + 1, 0)});
-  }
-  
-  // Bottom boundary (only 1 cell in bottom row)
-  adjacencylist_[VertexIndex(rows_ - 1, 0)].push_back(
-      {-1, std::make_shared<LineBorder>(0, rows_, 1, rows_)});
+  // Bottom boundary
+  for (int i = 0; i < rows_; ++i) AddBoundary(4 * i + 3);
 
-  // Left and right boundaries
   for (int row = 0; row < rows_; ++row) {
-    int cells_in_row = CellsInRow(row);
-    
-    // Left boundary (except for entry)
-    if (row != 0) {
-      adjacencylist_[VertexIndex(row, 0)].push_back(
-          {-1, std::make_shared<LineBorder>(0, row, 0, row + 1)});
-    }
-    
-    // Right boundary (except for exit)
-    if (!(row == rows_ - 1 && cells_in_row == 1)) {
-      adjacencylist_[VertexIndex(row, cells_in_row - 1)].push_back(
-          {-1, std::make_shared<LineBorder>(cells_in_row, row, cells_in_row, row + 1)});
-    }
-  }
-  
-  // Add diagonal boundary walls on the right edge
-  for (int row = 0; row < rows_ - 1; ++row) {
-    int cells_in_row = CellsInRow(row);
-    int cells_in_next_row = CellsInRow(row + 1);
-    
-    // Add diagonal wall from rightmost cell of current row to rightmost cell of next row
-    if (!(row == rows_ - 2 && cells_in_next_row == 1)) { // except for exit
-      adjacencylist_[VertexIndex(row, cells_in_row - 1)].push_back(
-          {-1, std::make_shared<LineBorder>(cells_in_row, row + 1, cells_in_next_row, row + 1)});
-    }
-  }
+    // Left boundary, except for entry
+    if (row != 0) AddBoundary(4 * lattice_->VertexIndex(row, 0) + 2);
 
-  // Horizontal connections within each row
-  for (int row = 0; row < rows_; ++row) {
-    int cells_in_row = CellsInRow(row);
-    for (int col = 0; col < cells_in_row - 1; ++col) {
-      std::shared_ptr<LineBorder> ptr =
-          std::make_shared<LineBorder>(col + 1, row, col + 1, row + 1);
-      adjacencylist_[VertexIndex(row, col)].push_back({VertexIndex(row, col + 1), ptr});
-      adjacencylist_[VertexIndex(row, col + 1)].push_back({VertexIndex(row, col), ptr});
-    }
+    // Right and top boundaries of the rightmost cell, except for exit and
+    // the top of the row just above it
+    int last = lattice_->VertexIndex(row, lattice_->CellsInRow(row) - 1);
+    if (row != rows_ - 1) AddBoundary(4 * last);
+    if (row != rows_ - 2) AddBoundary(4 * last + 1);
   }
 
-  // Vertical connections between rows
-  for (int row = 0; row < rows_ - 1; ++row) {
-    int cells_in_next_row = CellsInRow(row + 1);
-    
-    for (int col = 0; col < cells_in_next_row; ++col) {
-      std::shared_ptr<LineBorder> ptr =
-          std::make_shared<LineBorder>(col, row + 1, col + 1, row + 1);
-      adjacencylist_[VertexIndex(row, col)].push_back({VertexIndex(row + 1, col), ptr});
-      adjacencylist_[VertexIndex(row + 1, col)].push_back({VertexIndex(row, col), ptr});
-    }
-  }
+  FinaliseGraph();
+}
+
+std::shared_ptr<CellBorder> TriangularMaze::GetBorder(int edgeid) const {
+  int ends[4];
+  WallEnds(edgeid, ends);
+  return std::make_shared<LineBorder>(ends[0], ends[1], ends[2], ends[3]);
+}
+
+void TriangularMaze::PrintWall(MazeWriter& writer, int edgeid) const {
+  int ends[4];
+  WallEnds(edgeid, ends);
+  writer.Line(ends[0], ends[1], ends[2], ends[3]);
+}
+
+void TriangularMaze::WallEnds(int edgeid, int ends[4]) const {
+  // Endpoint offsets of the right, top, left and bottom walls of a cell
+  static const int offsets[4][4] = {
+      {1, 0, 1, 1}, {0, 1, 1, 1}, {0, 0, 0, 1}, {0, 0, 1, 0}};
+  auto [row, col] = lattice_->CellCoordinates(edgeid / 4);
+  const int* offset = offsets[edgeid % 4];
+  ends[0] = col + offset[0];
+  ends[1] = row + offset[1];
+  ends[2] = col + offset[2];
+  ends[3] = row + offset[3];
 }
 
 std::tuple<double, double, double, double> TriangularMaze::GetCoordinateBounds() const {
   return std::make_tuple(0, 0, rows_, rows_);
-}
\ No newline at end of file
+}
@@ -3,23 +3,57 @@
 
 #include "../maze/maze.h"
 
-class TriangularMaze : public Maze {
+// Rows of rectangular cells, each one cell shorter than the one below it.
+// Like the rectangular maze, cells own the walls 4 * vertex + direction to
+// their right (0) and top (1), boundary cells also those to their left (2)
+// and bottom (3).
+class TriangularGraph : public Graph, public Lattice {
  private:
-  int rows_;  // Number of rows in the triangle
-  
+  int rows_;
+
+ public:
+  TriangularGraph(int rows);
+
   // Get vertex index for a cell at (row, col)
   int VertexIndex(int row, int col) const;
-  
+
   // Get number of cells in a given row
   int CellsInRow(int row) const;
-  
+
   // Get total number of cells up to (but not including) a given row
   int CellsBeforeRow(int row) const;
 
+  // Get (row, col) of the cell at a vertex index
+  std::pair<int, int> CellCoordinates(int vertex) const;
+
+  int Vertices() const override;
+  int Edges() const override;
+  int MaxDegree() const override;
+  int Neighbors(int vertex, int* neighbors, int* edgeids) const override;
+
+  int Rows() const override { return rows_; }
+  int Columns(int row) const override { return CellsInRow(row); }
+  int Vertex(int row, int col) const override { return VertexIndex(row, col); }
+};
+
+class TriangularMaze : public Maze {
+ private:
+  int rows_;  // Number of rows in the triangle
+  std::shared_ptr<const TriangularGraph> lattice_;
+
+  std::shared_ptr<CellBorder> GetBorder(int edgeid) const override;
+  // Walls have integer coordinates, written without a border
+  void PrintWall(MazeWriter& writer, int edgeid) const override;
+  // Endpoints x1, y1, x2, y2 of the wall of an edge
+  void WallEnds(int edgeid, int ends[4]) const;
+
  public:
   TriangularMaze(int rows);
+  std::unique_ptr<Maze> Clone() const override {
+    return std::make_unique<TriangularMaze>(*this);
+  }
   void InitialiseGraph() override;
   std::tuple<double, double, double, double> GetCoordinateBounds() const override;
 };
 
-#endif  // MAZETYPES_TRIANGULARMAZE_H_
\ No newline at end of file
+#endif  // MAZETYPES_TRIANGULARMAZE_H_
@@ -1,48 +1,233 @@
 #include "usermaze.h"
-#include <fstream>
+#include "mappedfile.h"
+#include "parallel.h"
+#include "topologycache.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 
-UserMaze::UserMaze(std::string filename) : filename_(filename) {}
+namespace {
+bool IsSpace(char c) { return c == ' ' or c == '\t' or c == '\r'; }
+
+// Skips spaces, returns whether the rest of the line is empty
+bool AtEnd(const char*& position, const char* end) {
+  while (position < end and IsSpace(*position)) ++position;
+  return position == end;
+}
+
+bool ParseInt(const char*& position, const char* end, int& value) {
+  AtEnd(position, end);
+  auto result = std::from_chars(position, end, value);
+  if (result.ec != std::errc() or
+      (result.ptr < end and !IsSpace(*result.ptr)))
+    return false;
+  position = result.ptr;
+  return true;
+}
+
+bool ParseDouble(const char*& position, const char* end, double& value) {
+  AtEnd(position, end);
+  if (position < end and *position == '+') ++position;
+  auto result = std::from_chars(position, end, value);
+  if (result.ec != std::errc() or
+      (result.ptr < end and !IsSpace(*result.ptr)))
+    return false;
+  position = result.ptr;
+  return true;
+}
+
+// Parses "u v Line x1 y1 x2 y2" or "u v Arc cx cy r theta1 theta2", and
+// returns what is wrong with the line, if anything
+std::string ParseEdge(const char* position, const char* end, int vertices,
+                      int& u, int& v, BorderRecord& border) {
+  if (!ParseInt(position, end, u) or !ParseInt(position, end, v))
+    return "expected the two vertices of an edge";
+  if (u < 0 or u >= vertices or v < -1 or v >= vertices)
+    return "vertex out of range";
+
+  AtEnd(position, end);
+  const char* type = position;
+  while (position < end and !IsSpace(*position)) ++position;
+  size_t typelength = position - type;
+  int values;
+  if (typelength == 4 and std::memcmp(type, "Line", 4) == 0) {
+    border.arc = 0;
+    values = 4;
+  } else if (typelength == 3 and std::memcmp(type, "Arc", 3) == 0) {
+    border.arc = 1;
+    values = 5;
+  } else {
+    return "unknown border type '" + std::string(type, typelength) + "'";
+  }
+  std::fill(border.values, border.values + 5, 0);
+  for (int i = 0; i < values; ++i) {
+    if (!ParseDouble(position, end, border.values[i]))
+      return "expected " + std::to_string(values) + " coordinates";
+  }
+  if (!AtEnd(position, end)) return "unexpected text after the coordinates";
+  return "";
+}
+}  // namespace
+
+UserMaze::UserMaze(std::string filename, std::string cachedirectory)
+    : filename_(filename), cachedirectory_(cachedirectory) {}
 
 void UserMaze::InitialiseGraph() {
   Maze::InitialiseGraph();
+  std::unique_ptr<TopologyCache> cache;
+  if (cachedirectory_ != "")
+    cache = std::make_unique<TopologyCache>(cachedirectory_, 5, 0, filename_);
 
-  std::ifstream in(filename_);
-  in >> vertices_;
+  TopologyCache::Topology topology;
+  bool cached = cache and cache->Load(topology);
+  if (cached) {
+    graph_ = topology.graph;
+    vertices_ = graph_->Vertices();
+    boundary_ = std::move(topology.boundary);
+    borders_ = topology.borders;
+    std::tie(xmin_, ymin_, xmax_, ymax_) = topology.bounds;
+  } else {
+    ReadGraph();
+  }
   startvertex_ = 0;
   endvertex_ = vertices_ - 1;
+  FinaliseGraph();
+
+  if (cache and !cached) {
+    topology.graph = graph_;
+    topology.boundary = boundary_;
+    topology.borders = borders_;
+    topology.bounds = GetCoordinateBounds();
+    cache->Store(topology);
+  }
+}
+
+void UserMaze::ReadGraph() {
+  size_t length;
+  auto data = MapFile(filename_, length);
+  if (!data) throw std::invalid_argument("Cannot read " + filename_);
+  const char *text = data.get(), *textend = text + length;
+  auto error = [&](long long line, const std::string& message) {
+    return std::invalid_argument(filename_ + ":" + std::to_string(line) +
+                                 ": " + message);
+  };
 
-  adjacencylist_.clear();
-  adjacencylist_.resize(vertices_);
-
-  xmin_ = std::numeric_limits<double>::max(), ymin_ = xmin_;
-  xmax_ = std::numeric_limits<double>::min(), ymax_ = xmax_;
-  int i, j;
-  while (in >> i >> j) {
-    std::string bordertype;
-    in >> bordertype;
-    if (bordertype == "Line") {
-      double x1, x2, y1, y2;
-      in >> x1 >> y1 >> x2 >> y2;
-      xmax_ = std::max(xmax_, x2);
-      ymax_ = std::max(ymax_, y2);
-      xmin_ = std::min(xmin_, x1);
-      ymin_ = std::min(ymin_, y1);
-      adjacencylist_[i].push_back(
-          {j, std::make_shared<LineBorder>(x1, y1, x2, y2)});
-    } else if (bordertype == "Arc") {
-      double cx, cy, r, theta1, theta2;
-      in >> cx >> cy >> r >> theta1 >> theta2;
-      xmax_ = std::max(xmax_, cx + r);
-      ymax_ = std::max(ymax_, cy + r);
-      xmin_ = std::min(xmin_, cx - r);
-      ymin_ = std::min(ymin_, cy - r);
-      adjacencylist_[i].push_back(
-          {j, std::make_shared<ArcBorder>(cx, cy, r, theta1, theta2)});
-    } else
-      continue;
-    if (j != -1)
-      adjacencylist_[j].push_back({i, std::get<1>(adjacencylist_[i].back())});
+  const char* position = text;
+  const char* lineend = std::find(position, textend, '\n');
+  if (!ParseInt(position, lineend, vertices_) or vertices_ < 1 or
+      !AtEnd(position, lineend))
+    throw error(1, "expected the number of vertices");
+
+  // The edges are split into chunks at line ends and parsed in parallel.
+  // Each chunk first counts its lines, which places its edges and numbers
+  // its lines, then parses them in place.
+  struct Chunk {
+    const char *begin, *end;
+    long long lines, first, edges;
+    long long errorline;
+    std::string error;
+    double xmin, ymin, xmax, ymax;
+  };
+  const size_t chunksize = 1 << 22;
+  std::vector<Chunk> chunks;
+  for (const char* begin = std::min(lineend + 1, textend); begin < textend;) {
+    const char* end = begin + std::min<size_t>(chunksize, textend - begin);
+    end = std::min(std::find(end, textend, '\n') + 1, textend);
+    chunks.push_back({begin, end, 0, 0, 0, -1, "", 0, 0, 0, 0});
+    begin = end;
+  }
+  ParallelFor(chunks.size(), [&](int i) {
+    Chunk& chunk = chunks[i];
+    chunk.lines = std::count(chunk.begin, chunk.end, '\n') +
+                  (chunk.end[-1] != '\n');
+  });
+  long long lines = 0;
+  for (auto& chunk : chunks) {
+    chunk.first = lines;
+    lines += chunk.lines;
   }
+
+  edges_.resize(lines);
+  std::vector<BorderRecord> borders(lines);
+  ParallelFor(chunks.size(), [&](int i) {
+    Chunk& chunk = chunks[i];
+    chunk.xmin = chunk.ymin = std::numeric_limits<double>::max();
+    chunk.xmax = chunk.ymax = std::numeric_limits<double>::min();
+    long long line = 0;
+    for (const char* begin = chunk.begin; begin < chunk.end; ++line) {
+      const char* end = std::find(begin, chunk.end, '\n');
+      const char* position = begin;
+      begin = end + 1;
+      if (AtEnd(position, end)) continue;
+
+      int u, v;
+      BorderRecord& border = borders[chunk.first + chunk.edges];
+      std::string message = ParseEdge(position, end, vertices_, u, v, border);
+      if (message != "") {
+        chunk.errorline = line;
+        chunk.error = message;
+        return;
+      }
+      edges_[chunk.first + chunk.edges++] = {u, v};
+
+      // Bounds as the streamed reader had them, from the far corner of
+      // lines and the box around arcs
+      const double* values = border.values;
+      if (border.arc) {
+        chunk.xmax = std::max(chunk.xmax, values[0] + values[2]);
+        chunk.ymax = std::max(chunk.ymax, values[1] + values[2]);
+        chunk.xmin = std::min(chunk.xmin, values[0] - values[2]);
+        chunk.ymin = std::min(chunk.ymin, values[1] - values[2]);
+      } else {
+        chunk.xmax = std::max(chunk.xmax, values[2]);
+        chunk.ymax = std::max(chunk.ymax, values[3]);
+        chunk.xmin = std::min(chunk.xmin, values[0]);
+        chunk.ymin = std::min(chunk.ymin, values[1]);
+      }
+    }
+  });
+  // The text is not needed any more, unmapping it lowers the peak memory
+  data.reset();
+
+  // Merge the chunks in order, closing the gaps left by blank lines, so
+  // edges are numbered as they appear in the file
+  xmin_ = ymin_ = std::numeric_limits<double>::max();
+  xmax_ = ymax_ = std::numeric_limits<double>::min();
+  long long edges = 0;
+  for (const auto& chunk : chunks) {
+    if (chunk.errorline >= 0)
+      throw error(2 + chunk.first + chunk.errorline, chunk.error);
+    if (edges != chunk.first) {
+      std::move(edges_.begin() + chunk.first,
+                edges_.begin() + chunk.first + chunk.edges,
+                edges_.begin() + edges);
+      std::move(borders.begin() + chunk.first,
+                borders.begin() + chunk.first + chunk.edges,
+                borders.begin() + edges);
+    }
+    edges += chunk.edges;
+    xmin_ = std::min(xmin_, chunk.xmin);
+    ymin_ = std::min(ymin_, chunk.ymin);
+    xmax_ = std::max(xmax_, chunk.xmax);
+    ymax_ = std::max(ymax_, chunk.ymax);
+  }
+  edges_.resize(edges);
+  borders.resize(edges);
+  for (long long i = 0; i < edges; ++i) {
+    if (edges_[i].second < 0) AddBoundary(i);
+  }
+
+  borders_ = BorderStore(borders);
+}
+
+std::shared_ptr<CellBorder> UserMaze::GetBorder(int edgeid) const {
+  return borders_.Border(edgeid);
+}
+
+void UserMaze::PrintWall(MazeWriter& writer, int edgeid) const {
+  borders_.Write(edgeid, writer);
 }
 
 std::tuple<double, double, double, double> UserMaze::GetCoordinateBounds()
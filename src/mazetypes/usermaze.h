@@ -1,14 +1,32 @@
+#include "borderstore.h"
 #include "maze.h"
 
+// Maze on a graph read from a file. The first line holds the number of
+// vertices, and every other line an edge as the two vertices it joins and
+// its wall, either "Line x1 y1 x2 y2" or "Arc cx cy r theta1 theta2". An
+// edge to vertex -1 is a boundary wall. Malformed lines are rejected with
+// std::invalid_argument naming the file and line.
 class UserMaze : public Maze {
  public:
-  UserMaze(std::string);
+  // The initialised graph is cached in the directory if there is one
+  UserMaze(std::string, std::string cachedirectory = "");
+  std::unique_ptr<Maze> Clone() const {
+    return std::make_unique<UserMaze>(*this);
+  }
   virtual void InitialiseGraph();
 
+ protected:
+  virtual std::shared_ptr<CellBorder> GetBorder(int) const;
+  virtual void PrintWall(MazeWriter&, int) const;
+
  private:
   double xmin_, ymin_, xmax_, ymax_;
-  std::string filename_;
+  std::string filename_, cachedirectory_;
+  // Geometry of every wall by edge id, shared between clones
+  BorderStore borders_;
 
+  // Reads the edges and their walls from the file
+  void ReadGraph();
   virtual std::tuple<double, double, double, double> GetCoordinateBounds()
       const;
 };
@@ -0,0 +1,68 @@
+// Throughput benchmarks for the spanning tree algorithms on large lattices.
+// Usage: run_benchmark [edges ...], defaults to 10^7, 3*10^7 and 10^8 edges
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/algorithms/boruvka.h"
+#include "../src/algorithms/cyclepopping.h"
+#include "../src/algorithms/kruskal.h"
+#include "../src/algorithms/looperasedrandomwalk.h"
+#include "../src/algorithms/parallel.h"
+#include "../src/mazetypes/rectangularmaze.h"
+
+// Counts the carved edges without storing them
+class CountingSink : public EdgeSink {
+public:
+    long long edges = 0;
+    void AddEdge(int, int, int) { edges++; }
+};
+
+void benchmark(const std::string& name, SpanningtreeAlgorithm& algorithm,
+               long long edges) {
+    // A square lattice of side n has 2n(n-1) interior edges
+    int side = std::ceil(std::sqrt(edges / 2.0)) + 1;
+    RectangularGraph graph(side, side);
+    long long latticeedges = 2LL * side * (side - 1);
+
+    // A fixed seed keeps the random walks of Wilson and cycle popping, whose
+    // length varies a lot, comparable between runs
+    algorithm.Seed(1);
+    CountingSink sink;
+    auto start = std::chrono::steady_clock::now();
+    algorithm.SpanningTree(graph.Vertices(), graph, sink);
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (sink.edges != graph.Vertices() - 1) {
+        std::cerr << name << " returned " << sink.edges << " edges, expected "
+                  << graph.Vertices() - 1 << std::endl;
+        exit(1);
+    }
+    std::cout << name << " " << side << "x" << side << ": " << latticeedges
+              << " edges in " << seconds << " s, "
+              << seconds * 1e9 / latticeedges << " ns/edge, "
+              << latticeedges / seconds / 1e6 << " Medges/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::vector<long long> sizes = {10000000LL, 30000000LL, 100000000LL};
+    if (argc > 1) {
+        sizes.clear();
+        for (int i = 1; i < argc; i++) sizes.push_back(std::atoll(argv[i]));
+    }
+
+    std::cout << "=== Maze Generator Benchmarks (" << Threads()
+              << " threads) ===" << std::endl;
+    Kruskal kruskal;
+    Boruvka boruvka;
+    LoopErasedRandomWalk wilson;
+    CyclePopping popping;
+    for (long long edges : sizes) benchmark("Kruskal", kruskal, edges);
+    for (long long edges : sizes) benchmark("Boruvka", boruvka, edges);
+    for (long long edges : sizes) benchmark("Wilson", wilson, edges);
+    for (long long edges : sizes) benchmark("Cycle popping", popping, edges);
+    return 0;
+}
@@ -7,15 +7,40 @@
 #include <memory>
 #include <functional>
 #include <tuple>
+#include <algorithm>
+#include <thread>
+#include <numeric>
+#include <stdexcept>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
 #include "../src/algorithms/spanningtreealgorithm.h"
 #include "../src/maze/maze.h"
 #include "../src/mazetypes/rectangularmaze.h"
 #include "../src/mazetypes/circularmaze.h"
 #include "../src/mazetypes/triangularmaze.h"
 #include "../src/mazetypes/hexagonalmaze.h"
+#include "../src/mazetypes/usermaze.h"
+#include "../src/mazetypes/streamedmaze.h"
+#include "../src/maze/borderstore.h"
+#include "../src/maze/topologycache.h"
 #include "../src/algorithms/depthfirstsearch.h"
 #include "../src/algorithms/breadthfirstsearch.h"
+#include "../src/algorithms/cyclepopping.h"
+#include "../src/algorithms/boruvka.h"
+#include "../src/algorithms/parallel.h"
 #include "../src/algorithms/kruskal.h"
+#include "../src/algorithms/looperasedrandomwalk.h"
+#include "../src/algorithms/prim.h"
+#include "../src/algorithms/eller.h"
+#include "../src/algorithms/recursivedivision.h"
+#include "../src/algorithms/binarytree.h"
+#include "../src/algorithms/sidewinder.h"
+#include "../src/algorithms/growingtree.h"
 
 // Test utilities
 class TestRunner {
@@ -47,6 +72,18 @@ public:
     }
 };
 
+// Counts heap allocations of the whole program
+static long allocations = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
 // Test helper classes to access protected members
 template<typename MazeType>
 class TestableMaze : public MazeType {
@@ -56,7 +93,19 @@ public:
     int GetVertexCount() const { return this->vertices_; }
     int GetStart() const { return this->startvertex_; }
     int GetEnd() const { return this->endvertex_; }
-    const Graph& GetGraph() const { return this->adjacencylist_; }
+    const Graph& GetGraph() const { return *this->graph_; }
+    const std::vector<int>& GetBoundary() const { return this->boundary_; }
+    std::shared_ptr<CellBorder> Border(int edgeid) const {
+        return this->GetBorder(edgeid);
+    }
+    std::vector<int> GetWalls() const {
+        std::vector<int> walls;
+        this->walls_.ForEach([&](int edgeid) { walls.push_back(edgeid); });
+        return walls;
+    }
+    std::unique_ptr<Maze> Clone() const {
+        return std::make_unique<TestableMaze>(*this);
+    }
 };
 
 // Helper functions
@@ -99,13 +148,15 @@ bool is_connected_graph(TestableMaze<MazeType>* maze, const std::vector<std::pai
     visited.insert(maze->GetStart());
     
     const Graph& graph = maze->GetGraph();
+    std::vector<int> neighbors(graph.MaxDegree()), edgeids(graph.MaxDegree());
     
     while (!queue.empty()) {
         int current = queue.front();
         queue.pop();
         
-        for (const auto& edge : graph[current]) {
-            int to = std::get<0>(edge);
+        int degree = graph.Neighbors(current, neighbors.data(), edgeids.data());
+        for (int i = 0; i < degree; i++) {
+            int to = neighbors[i];
             if (to >= 0 && visited.find(to) == visited.end()) {
                 visited.insert(to);
                 queue.push(to);
@@ -121,10 +172,12 @@ bool is_spanning_tree(TestableMaze<MazeType>* maze) {
     // A spanning tree has exactly V-1 edges for V vertices
     std::set<std::pair<int, int>> counted_edges;
     const Graph& graph = maze->GetGraph();
+    std::vector<int> neighbors(graph.MaxDegree()), edgeids(graph.MaxDegree());
     
     for (int v = 0; v < maze->GetVertexCount(); v++) {
-        for (const auto& edge : graph[v]) {
-            int to = std::get<0>(edge);
+        int degree = graph.Neighbors(v, neighbors.data(), edgeids.data());
+        for (int i = 0; i < degree; i++) {
+            int to = neighbors[i];
             if (to >= 0) {
                 // Count each edge only once
                 int v1 = std::min(v, to);
@@ -139,19 +192,17 @@ bool is_spanning_tree(TestableMaze<MazeType>* maze) {
 
 template<typename MazeType>
 int count_boundary_walls(TestableMaze<MazeType>* maze) {
-    // Count edges with to == -1 (boundary edges)
-    int walls = 0;
+    // Boundary walls are kept apart from the graph the algorithms traverse
     const Graph& graph = maze->GetGraph();
+    std::vector<int> neighbors(graph.MaxDegree()), edgeids(graph.MaxDegree());
     
     for (int v = 0; v < maze->GetVertexCount(); v++) {
-        for (const auto& edge : graph[v]) {
-            int to = std::get<0>(edge);
-            if (to == -1) {
-                walls++;
-            }
+        int degree = graph.Neighbors(v, neighbors.data(), edgeids.data());
+        for (int i = 0; i < degree; i++) {
+            assert(neighbors[i] >= 0 && neighbors[i] < maze->GetVertexCount());
         }
     }
-    return walls;
+    return maze->GetBoundary().size();
 }
 
 // Test functions
@@ -166,14 +217,16 @@ void test_rectangular_maze_structure() {
     
     // Check adjacency list is initialized
     const Graph& graph = maze.GetGraph();
-    assert(graph.size() == 25);
+    std::vector<int> neighbors(graph.MaxDegree()), edgeids(graph.MaxDegree());
+    assert(graph.Vertices() == 25);
     
     // Check that interior vertices have correct number of potential connections
     // Interior vertex (2,2) = index 12 should have 4 neighbors
     int interior_vertex = 12;
     int neighbor_count = 0;
-    for (const auto& edge : graph[interior_vertex]) {
-        int to = std::get<0>(edge);
+    int degree = graph.Neighbors(interior_vertex, neighbors.data(), edgeids.data());
+    for (int i = 0; i < degree; i++) {
+        int to = neighbors[i];
         if (to >= 0) neighbor_count++;
     }
     assert(neighbor_count == 4);
@@ -362,6 +415,871 @@ void test_solution_path_exists() {
     assert(maze.GetStart() != maze.GetEnd());
 }
 
+void test_spanning_tree_edge_ids() {
+    TestableMaze<HexagonalMaze> maze(4);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+    std::vector<int> neighbors(graph.MaxDegree()), edgeids(graph.MaxDegree());
+
+    // Endpoints of every interior edge by id
+    std::map<int, std::pair<int, int>> endpoints;
+    for (int v = 0; v < graph.Vertices(); v++) {
+        int degree = graph.Neighbors(v, neighbors.data(), edgeids.data());
+        for (int i = 0; i < degree; i++) {
+            if (neighbors[i] > v) endpoints[edgeids[i]] = {v, neighbors[i]};
+        }
+    }
+
+    DepthFirstSearch dfs;
+    BreadthFirstSearch bfs;
+    Kruskal kruskal;
+    Boruvka boruvka;
+    Prim prim;
+    GrowingTree growingtree({2, 1, 1});
+    for (SpanningtreeAlgorithm* algorithm : std::vector<SpanningtreeAlgorithm*>{
+             &dfs, &bfs, &kruskal, &boruvka, &prim, &growingtree}) {
+        auto tree = algorithm->SpanningTreeEdges(graph.Vertices(), graph);
+        assert(tree.size() == static_cast<size_t>(graph.Vertices() - 1));
+
+        // V-1 distinct interior edges without a cycle form a spanning tree
+        std::vector<int> component(graph.Vertices());
+        std::iota(component.begin(), component.end(), 0);
+        std::function<int(int)> find = [&](int v) {
+            return component[v] == v ? v : component[v] = find(component[v]);
+        };
+        for (int edgeid : tree) {
+            assert(endpoints.count(edgeid));
+            int u = find(endpoints[edgeid].first);
+            int v = find(endpoints[edgeid].second);
+            assert(u != v);
+            component[u] = v;
+        }
+    }
+}
+
+void test_edge_sink_grows_tree() {
+    TestableMaze<CircularMaze> maze(6);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+
+    // Every edge must extend the tree grown so far by one new vertex
+    class TreeChecker : public EdgeSink {
+    public:
+        std::vector<bool> intree;
+        int edges = 0;
+        void AddEdge(int from, int to, int) {
+            if (edges++ == 0) intree[from] = true;
+            assert(intree[from] && !intree[to]);
+            intree[to] = true;
+        }
+    };
+
+    DepthFirstSearch dfs;
+    BreadthFirstSearch bfs;
+    Prim prim;
+    LoopErasedRandomWalk lerw;
+    GrowingTree newest, oldest({0, 1, 0}), random({0, 0, 1}),
+        mixed({3, 0, 1});
+    for (SpanningtreeAlgorithm* algorithm : std::vector<SpanningtreeAlgorithm*>{
+             &dfs, &bfs, &prim, &lerw, &newest, &oldest, &random, &mixed}) {
+        TreeChecker checker;
+        checker.intree.assign(graph.Vertices(), false);
+        algorithm->SpanningTree(graph.Vertices(), graph, checker);
+        assert(checker.edges == graph.Vertices() - 1);
+    }
+}
+
+void test_parallel_boruvka() {
+    // Enough vertices for several chunks, with more threads than cores so
+    // that unions race
+    TestableMaze<RectangularMaze> maze(300, 300);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+
+    SetThreads(4);
+    Boruvka boruvka;
+    auto tree = boruvka.SpanningTreeEdges(graph.Vertices(), graph);
+    SetThreads(std::thread::hardware_concurrency());
+
+    assert(tree.size() == static_cast<size_t>(graph.Vertices() - 1));
+    std::set<int> distinct(tree.begin(), tree.end());
+    assert(distinct.size() == tree.size());
+}
+
+// A 3x3 grid has 192 spanning trees, which should all be about equally
+// likely. The bounds are 7 standard deviations wide.
+void check_uniform_on_grid(SpanningtreeAlgorithm& algorithm) {
+    TestableMaze<RectangularMaze> maze(3, 3);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+
+    std::map<std::vector<int>, int> counts;
+    for (int i = 0; i < 192 * 200; i++) {
+        auto tree = algorithm.SpanningTreeEdges(graph.Vertices(), graph);
+        std::sort(tree.begin(), tree.end());
+        counts[tree]++;
+    }
+    assert(counts.size() == 192);
+    for (const auto& [tree, count] : counts) {
+        assert(count > 100 && count < 300);
+    }
+}
+
+void test_loop_erased_random_walk_uniform() {
+    LoopErasedRandomWalk lerw;
+    check_uniform_on_grid(lerw);
+}
+
+void test_random() {
+    Random a(5), b(5), c(6);
+    for (int i = 0; i < 100; i++) {
+        uint64_t x = a();
+        assert(x == b());
+        assert(x != c());
+    }
+
+    // Bounded draws stay in range and cover it evenly
+    std::vector<int> counts(7, 0);
+    for (int i = 0; i < 70000; i++) counts[a.Bounded(7)]++;
+    for (int count : counts) assert(count > 9000 && count < 11000);
+
+    std::vector<int> values(1001);
+    std::iota(values.begin(), values.end(), 0);
+    a.Shuffle(values.begin(), values.end());
+    assert(!std::is_sorted(values.begin(), values.end()));
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i <= 1000; i++) assert(values[i] == i);
+}
+
+void test_seeded_mazes_repeat() {
+    TestableMaze<HexagonalMaze> maze(8);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+
+    DepthFirstSearch dfs;
+    BreadthFirstSearch bfs;
+    Kruskal kruskal;
+    LoopErasedRandomWalk lerw;
+    Prim prim;
+    Boruvka boruvka;
+    CyclePopping popping;
+    for (SpanningtreeAlgorithm* algorithm : std::vector<SpanningtreeAlgorithm*>{
+             &dfs, &bfs, &kruskal, &lerw, &prim, &boruvka, &popping}) {
+        algorithm->Seed(11);
+        auto first = algorithm->SpanningTreeEdges(graph.Vertices(), graph);
+        auto other = algorithm->SpanningTreeEdges(graph.Vertices(), graph);
+        algorithm->Seed(11);
+        assert(algorithm->SpanningTreeEdges(graph.Vertices(), graph) == first);
+        assert(other != first);
+    }
+}
+
+void test_parallel_bfs() {
+    // Levels wide enough for several chunks
+    TestableMaze<RectangularMaze> maze(400, 400);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+
+    class Recorder : public EdgeSink {
+    public:
+        std::vector<std::tuple<int, int, int>> edges;
+        void AddEdge(int from, int to, int edgeid) {
+            edges.push_back({from, to, edgeid});
+        }
+    };
+    Recorder recorders[2];
+    for (int threads : {1, 4}) {
+        SetThreads(threads);
+        BreadthFirstSearch bfs;
+        bfs.Seed(3);
+        bfs.SpanningTree(graph.Vertices(), graph, recorders[threads > 1]);
+    }
+    SetThreads(std::thread::hardware_concurrency());
+    assert(recorders[0].edges == recorders[1].edges);
+
+    // Depths in the tree are the distances in the grid
+    auto& edges = recorders[0].edges;
+    assert(edges.size() == static_cast<size_t>(graph.Vertices() - 1));
+    int root = std::get<0>(edges[0]);
+    std::vector<int> depth(graph.Vertices(), -1);
+    depth[root] = 0;
+    for (auto [from, to, edgeid] : edges) {
+        assert(depth[from] >= 0 && depth[to] < 0);
+        depth[to] = depth[from] + 1;
+    }
+    for (int v = 0; v < graph.Vertices(); v++) {
+        int rows = std::abs(v / 400 - root / 400);
+        int columns = std::abs(v % 400 - root % 400);
+        assert(depth[v] == rows + columns);
+    }
+}
+
+void test_cycle_popping() {
+    CyclePopping popping;
+    check_uniform_on_grid(popping);
+
+    // The tree only depends on the seed, not on how walks were interleaved
+    TestableMaze<HexagonalMaze> maze(60);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+    std::vector<int> trees[2];
+    for (int threads : {1, 4}) {
+        SetThreads(threads);
+        CyclePopping seeded;
+        seeded.Seed(7);
+        trees[threads > 1] = seeded.SpanningTreeEdges(graph.Vertices(), graph);
+    }
+    SetThreads(std::thread::hardware_concurrency());
+
+    std::sort(trees[0].begin(), trees[0].end());
+    std::sort(trees[1].begin(), trees[1].end());
+    assert(trees[0] == trees[1]);
+    assert(trees[0].size() == static_cast<size_t>(graph.Vertices() - 1));
+    std::set<int> distinct(trees[0].begin(), trees[0].end());
+    assert(distinct.size() == trees[0].size());
+}
+
+void test_tiled_spanning_tree() {
+    // Tiles which do not divide the maze evenly
+    const int width = 50, height = 37, tilesize = 8;
+    TestableMaze<RectangularMaze> maze(width, height);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+
+    std::vector<int> trees[2];
+    for (int threads : {1, 4}) {
+        SetThreads(threads);
+        TiledSpanningTree tiled(width, height, tilesize, []() {
+            return std::unique_ptr<SpanningtreeAlgorithm>(new Kruskal);
+        });
+        tiled.Seed(9);
+        trees[threads > 1] = tiled.SpanningTreeEdges(graph.Vertices(), graph);
+    }
+    SetThreads(std::thread::hardware_concurrency());
+    assert(trees[0] == trees[1]);
+
+    // A spanning tree with a single passage between tiles joined by a seam
+    auto& tree = trees[0];
+    assert(tree.size() == static_cast<size_t>(graph.Vertices() - 1));
+    std::vector<int> component(graph.Vertices());
+    std::iota(component.begin(), component.end(), 0);
+    std::function<int(int)> find = [&](int v) {
+        return component[v] == v ? v : component[v] = find(component[v]);
+    };
+    int seams = 0;
+    for (int edgeid : tree) {
+        int u = edgeid / 4, v = edgeid % 4 == 0 ? u + 1 : u + width;
+        assert(edgeid % 4 < 2 && v < graph.Vertices());
+        if (u % width / tilesize != v % width / tilesize ||
+            u / width / tilesize != v / width / tilesize) seams++;
+        u = find(u), v = find(v);
+        assert(u != v);
+        component[u] = v;
+    }
+    int tiles = ((width + tilesize - 1) / tilesize) *
+                ((height + tilesize - 1) / tilesize);
+    assert(seams == tiles - 1);
+}
+
+// Seeded trees of lattice algorithms do not depend on the number of threads
+template<typename MazeType>
+void check_lattice_tree(TestableMaze<MazeType>& maze,
+                        SpanningtreeAlgorithm& algorithm) {
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+    std::vector<int> neighbors(graph.MaxDegree()), edgeids(graph.MaxDegree());
+    std::map<int, std::pair<int, int>> endpoints;
+    for (int v = 0; v < graph.Vertices(); v++) {
+        int degree = graph.Neighbors(v, neighbors.data(), edgeids.data());
+        for (int i = 0; i < degree; i++) {
+            if (neighbors[i] > v) endpoints[edgeids[i]] = {v, neighbors[i]};
+        }
+    }
+
+    std::vector<int> trees[2];
+    for (int threads : {1, 4}) {
+        SetThreads(threads);
+        algorithm.Seed(2);
+        trees[threads > 1] =
+            algorithm.SpanningTreeEdges(graph.Vertices(), graph);
+    }
+    SetThreads(std::thread::hardware_concurrency());
+    assert(trees[0] == trees[1]);
+
+    auto& tree = trees[0];
+    assert(tree.size() == static_cast<size_t>(graph.Vertices() - 1));
+    std::vector<int> component(graph.Vertices());
+    std::iota(component.begin(), component.end(), 0);
+    std::function<int(int)> find = [&](int v) {
+        return component[v] == v ? v : component[v] = find(component[v]);
+    };
+    for (int edgeid : tree) {
+        assert(endpoints.count(edgeid));
+        int u = find(endpoints[edgeid].first);
+        int v = find(endpoints[edgeid].second);
+        assert(u != v);
+        component[u] = v;
+    }
+}
+
+void test_recursive_division() {
+    // Large enough for regions to be divided in parallel
+    RecursiveDivision division;
+    TestableMaze<RectangularMaze> rectangular(300, 170);
+    check_lattice_tree(rectangular, division);
+    TestableMaze<TriangularMaze> triangular(250);
+    check_lattice_tree(triangular, division);
+
+    // Other mazes have no lattice to divide
+    TestableMaze<HexagonalMaze> hexagonal(4);
+    hexagonal.InitialiseGraph();
+    const Graph& graph = hexagonal.GetGraph();
+    bool thrown = false;
+    try {
+        division.SpanningTreeEdges(graph.Vertices(), graph);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_row_algorithms() {
+    // Rows go to the sink in order, so the maze can be written while the
+    // algorithm goes
+    class RowChecker : public EdgeSink {
+    public:
+        int width, row = 0;
+        void AddEdge(int u, int v, int) {
+            assert(std::max(u, v) / width >= row);
+            row = std::max(u, v) / width;
+        }
+    };
+
+    Eller eller;
+    BinaryTree binarytree;
+    Sidewinder sidewinder;
+    for (SpanningtreeAlgorithm* algorithm : std::vector<SpanningtreeAlgorithm*>{
+             &eller, &binarytree, &sidewinder}) {
+        TestableMaze<RectangularMaze> rectangular(301, 170);
+        check_lattice_tree(rectangular, *algorithm);
+        RowChecker checker;
+        checker.width = 301;
+        algorithm->SpanningTree(rectangular.GetVertexCount(),
+                                rectangular.GetGraph(), checker);
+        assert(checker.row == 169);
+    }
+
+    // Binary tree and sidewinder only go left and down, which every cell of
+    // a triangular maze but the first can do
+    TestableMaze<TriangularMaze> triangular(250);
+    check_lattice_tree(triangular, binarytree);
+    check_lattice_tree(triangular, sidewinder);
+
+    // Eller's algorithm needs rows of the same width
+    const Graph& graph = triangular.GetGraph();
+    bool thrown = false;
+    try {
+        eller.SpanningTreeEdges(graph.Vertices(), graph);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_streamed_maze_size() {
+    // Edge ids 4 * cell + direction are ints, which bounds the mazes held as
+    // graphs
+    assert(RectangularGraph::maxcells == INT_MAX / 4);
+    assert(RectangularGraph::Fits(16384, 32767));
+    assert(RectangularGraph::Fits(1, RectangularGraph::maxcells));
+    assert(!RectangularGraph::Fits(16384, 32768));
+    assert(!RectangularGraph::Fits(1000, 2200000));
+    assert(!RectangularGraph::Fits(46341, 46341));
+
+    // Counts the walls of a streamed maze, which come row by row
+    struct RowCounter : public MazeWriter {
+        long long walls = 0;
+        double row = 0;
+        void Line(double, double y1, double, double y2) {
+            assert(std::min(y1, y2) >= row);
+            row = std::min(y1, y2);
+            ++walls;
+        }
+        void Arc(double, double, double, double, double) { assert(false); }
+    };
+
+    // Algorithms numbering the cells refuse larger mazes before writing
+    BinaryTree binarytree;
+    RowCounter refused;
+    bool thrown = false;
+    try {
+        StreamedMaze(1000, 2200000).Generate(&binarytree, refused);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && refused.walls == 0);
+
+    // Eller's algorithm passes rows and columns, and streams past them. A
+    // spanning tree leaves width * height + width + height - 1 walls,
+    // counting the outline but the entry and the exit.
+    Eller eller;
+    for (auto size : {std::make_pair(30, 20), std::make_pair(1 << 14, 32769)}) {
+        RowCounter counter;
+        StreamedMaze(size.first, size.second).Generate(&eller, counter);
+        long long width = size.first, height = size.second;
+        assert(counter.walls == width * height + width + height - 1);
+        assert(counter.row == height);
+    }
+}
+
+void test_growing_tree() {
+    auto policy = GrowingTree::ParsePolicy("newest:3,random:1,newest");
+    assert(policy.newest == 4 && policy.oldest == 0 && policy.random == 1);
+    policy = GrowingTree::ParsePolicy("newest:2147483646,random:1");
+    assert(policy.newest == INT_MAX - 1 && policy.random == 1);
+    for (std::string text : {"", "latest", "newest:", "newest:-1", "oldest:0",
+                             "newest:2000000000,random:2000000000",
+                             "newest:2147483647,oldest:0,newest"}) {
+        bool thrown = false;
+        try {
+            GrowingTree::ParsePolicy(text);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    // Weights given directly are checked the same way, with the total
+    // summed without overflowing
+    for (GrowingTree::Policy weights : std::vector<GrowingTree::Policy>{
+             {0, 0, 0}, {-1, 2, 0}, {INT_MAX, 1, 0}, {INT_MAX, INT_MAX, 2}}) {
+        bool thrown = false;
+        try {
+            GrowingTree tree(weights);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    GrowingTree heaviest({INT_MAX, 0, 0});
+
+    // Always expanding the oldest vertex is a breadth-first search, so
+    // depths in the tree are distances in the grid
+    TestableMaze<RectangularMaze> maze(40, 30);
+    maze.InitialiseGraph();
+    const Graph& graph = maze.GetGraph();
+    class DepthRecorder : public EdgeSink {
+    public:
+        std::vector<int> depth;
+        int root = -1;
+        void AddEdge(int from, int to, int) {
+            if (root < 0) depth[root = from] = 0;
+            depth[to] = depth[from] + 1;
+        }
+    } recorder;
+    recorder.depth.assign(graph.Vertices(), -1);
+    GrowingTree oldest({0, 1, 0});
+    oldest.SpanningTree(graph.Vertices(), graph, recorder);
+    for (int v = 0; v < graph.Vertices(); v++) {
+        int rows = std::abs(v / 40 - recorder.root / 40);
+        int columns = std::abs(v % 40 - recorder.root % 40);
+        assert(recorder.depth[v] == rows + columns);
+    }
+
+    // Mixed policies still pick the newest or oldest vertex which can grow,
+    // adding their edge from that end of the order the vertices joined the
+    // tree. With three in four picks there, about 89% of the edges come from
+    // the newest end and 59% from the oldest one, which grows fewer edges
+    // per pick. Losing the order when dropping vertices takes them down to
+    // about 71% and 46%.
+    class EndRecorder : public EdgeSink {
+    public:
+        const Graph* graph;
+        bool oldest;
+        std::vector<char> visited;
+        std::vector<int> order;
+        size_t first = 0;
+        int edges = 0, fromend = 0;
+        bool Grows(int v) {
+            int neighbors[4], edgeids[4];
+            int degree = graph->Neighbors(v, neighbors, edgeids);
+            for (int i = 0; i < degree; i++) {
+                if (!visited[neighbors[i]]) return true;
+            }
+            return false;
+        }
+        void AddEdge(int from, int to, int) {
+            if (order.empty()) {
+                order.push_back(from);
+                visited[from] = 1;
+            }
+            // Vertices which cannot grow never can again
+            while (!Grows(order.back())) order.pop_back();
+            while (!Grows(order[first])) first++;
+            edges++;
+            fromend += from == (oldest ? order[first] : order.back());
+            order.push_back(to);
+            visited[to] = 1;
+        }
+    };
+    RectangularGraph square(100, 100);
+    for (bool oldest : {false, true}) {
+        GrowingTree mixed(oldest ? GrowingTree::Policy{0, 3, 1}
+                                 : GrowingTree::Policy{3, 0, 1});
+        mixed.Seed(7);
+        EndRecorder ends;
+        ends.graph = &square;
+        ends.oldest = oldest;
+        ends.visited.assign(square.Vertices(), 0);
+        mixed.SpanningTree(square.Vertices(), square, ends);
+        assert(ends.edges == square.Vertices() - 1);
+        assert(ends.fromend > ends.edges * (oldest ? 0.53 : 0.8));
+    }
+}
+
+void test_batch_clones() {
+    // Clones share the graph of the initialised maze but carve their own
+    // walls, and the prototype keeps all of its walls
+    TestableMaze<HexagonalMaze> prototype(6);
+    prototype.InitialiseGraph();
+    auto walls = prototype.GetWalls();
+    std::vector<std::unique_ptr<Maze>> clones;
+    for (int seed : {1, 2, 1}) {
+        clones.push_back(prototype.Clone());
+        Kruskal kruskal;
+        kruskal.Seed(seed);
+        clones.back()->GenerateMaze(&kruskal);
+    }
+    auto clone = [&](int i) -> TestableMaze<HexagonalMaze>& {
+        return dynamic_cast<TestableMaze<HexagonalMaze>&>(*clones[i]);
+    };
+    assert(&clone(0).GetGraph() == &prototype.GetGraph());
+    assert(prototype.GetWalls() == walls);
+    assert(clone(0).GetWalls().size() < walls.size());
+    assert(clone(0).GetWalls() != clone(1).GetWalls());
+    assert(clone(0).GetWalls() == clone(2).GetWalls());
+
+    // Items come out in order, and producers wait while the queue is full
+    BoundedQueue<int> queue(2);
+    std::thread producer([&]() {
+        for (int i = 0; i < 100; i++) queue.Push(i);
+        queue.Close();
+    });
+    int item, expected = 0;
+    while (queue.Pop(item)) assert(item == expected++);
+    producer.join();
+    assert(expected == 100);
+}
+
+void test_generation_reuses_buffers() {
+    // Generating the same maze again reuses every buffer of the maze and
+    // the algorithm, and the threads of the parallel loops. Buffers grow to
+    // the largest maze so far, so other seeds may still grow them. The maze
+    // is large enough to split the parallel algorithms into several tasks,
+    // which run on several threads even on machines with a single core.
+    SetThreads(4);
+    std::vector<std::unique_ptr<SpanningtreeAlgorithm>> algorithms;
+    algorithms.emplace_back(new Kruskal);
+    algorithms.emplace_back(new DepthFirstSearch);
+    algorithms.emplace_back(new BreadthFirstSearch);
+    algorithms.emplace_back(new LoopErasedRandomWalk);
+    algorithms.emplace_back(new Prim);
+    algorithms.emplace_back(new Boruvka);
+    algorithms.emplace_back(new CyclePopping);
+    algorithms.emplace_back(new Eller);
+    algorithms.emplace_back(new RecursiveDivision);
+    algorithms.emplace_back(new BinaryTree);
+    algorithms.emplace_back(new Sidewinder);
+    algorithms.emplace_back(new GrowingTree({1, 1, 1}));
+    algorithms.emplace_back(new TiledSpanningTree(300, 200, 16, []() {
+        return std::unique_ptr<SpanningtreeAlgorithm>(new Prim);
+    }));
+    for (auto& algorithm : algorithms) {
+        TestableMaze<RectangularMaze> maze(300, 200);
+        maze.InitialiseGraph();
+        algorithm->Seed(5);
+        maze.GenerateMaze(algorithm.get());
+        auto walls = maze.GetWalls();
+
+        algorithm->Seed(5);
+        long before = allocations;
+        maze.GenerateMaze(algorithm.get());
+        assert(allocations == before);
+        assert(maze.GetWalls() == walls);
+    }
+
+    // Mazes with stored geometry use a compressed graph
+    TestableMaze<HexagonalMaze> maze(10);
+    maze.InitialiseGraph();
+    Kruskal kruskal;
+    kruskal.Seed(5);
+    maze.GenerateMaze(&kruskal);
+    kruskal.Seed(5);
+    long before = allocations;
+    maze.GenerateMaze(&kruskal);
+    assert(allocations == before);
+    SetThreads(std::thread::hardware_concurrency());
+}
+
+void test_buffered_writer() {
+    auto directory =
+        std::filesystem::temp_directory_path() / "mazegen_test_writer";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+    std::string prefix = (directory / "maze").string();
+    auto read = [](const std::string& filename) {
+        std::ifstream file(filename);
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    };
+
+    // Integral coordinates have no fraction, others at most the precision
+    // without trailing zeros, and writing walls does not allocate
+    {
+        SVGWriter writer(prefix, std::make_tuple(0, 0, 2, 1), 2);
+        long before = allocations;
+        writer.Line(1, 0, 2, 0.5);
+        writer.Line(0.123456, -1.0 / 3, 0, 0);
+        writer.Arc(0, 0, 1, 0, M_PI / 2);
+        assert(allocations == before);
+    }
+    std::string svg = read(prefix + ".svg");
+    assert(svg.find("<svg width=\"120\" height=\"90\"") == 0);
+    assert(svg.find("<line x1=\"30\" x2=\"60\" y1=\"0\" y2=\"15\"") !=
+           std::string::npos);
+    assert(svg.find("<line x1=\"3.7\" x2=\"0\" y1=\"-10\" y2=\"0\"") !=
+           std::string::npos);
+    assert(svg.find("<path d=\"M 0 30 A 30 30, 0, 0, 0, 30 0\"") !=
+           std::string::npos);
+    assert(svg.size() > 12 && svg.substr(svg.size() - 12) == "</g>\n</svg>\n");
+
+    {
+        GnuplotWriter writer(prefix, std::make_tuple(0, 0, 2, 1));
+        writer.Line(0.5, 0, 0.123456789, 1);
+        writer.Arc(1, 1, 0.5, 0, 1.5);
+    }
+    std::string plt = read(prefix + ".plt");
+    assert(plt.find("set arrow from 0.5,0 to 0.123457,1 nohead") !=
+           std::string::npos);
+    assert(plt.find("plot [0:1.5] 1+cos(t)*0.5,1+sin(t)*0.5 w l") !=
+           std::string::npos);
+    assert(plt.find("set output '" + prefix + ".png'\n") != std::string::npos);
+
+    // Large mazes go through the buffer in several blocks
+    auto maze = std::make_unique<TestableMaze<RectangularMaze>>(300, 300);
+    maze->InitialiseGraph();
+    Kruskal kruskal;
+    maze->GenerateMaze(&kruskal);
+    maze->PrintMazeSVG(prefix);
+    svg = read(prefix + ".svg");
+    assert(svg.size() > (1 << 20));
+    assert(size_t(std::count(svg.begin(), svg.end(), '\n')) ==
+           5 + maze->GetBoundary().size() + maze->GetWalls().size());
+    std::filesystem::remove_all(directory);
+}
+
+// Records what a writer is given, the four values of every line and the five
+// of every arc
+struct WallRecorder : public MazeWriter {
+    std::vector<std::vector<double>> walls;
+    void Line(double x1, double y1, double x2, double y2) {
+        walls.push_back({x1, y1, x2, y2});
+    }
+    void Arc(double cx, double cy, double r, double theta1, double theta2) {
+        walls.push_back({cx, cy, r, theta1, theta2});
+    }
+};
+
+std::vector<double> recorded_wall(const CellBorder& border) {
+    WallRecorder recorder;
+    recorder.Write(border);
+    assert(recorder.walls.size() == 1);
+    return recorder.walls[0];
+}
+
+void test_border_store() {
+    std::vector<BorderRecord> records = {{0, {1, 0, 1, 1, 0}},
+                                         {1, {0, 0, 1, 0, 1.5}},
+                                         {0, {0, 1, 0.5, 1, 0}}};
+    auto check = [&](const BorderStore& store) {
+        assert(store.Edges() == 3 && store.Lines() == 2 && store.Arcs() == 1);
+        WallRecorder recorder;
+        for (int edgeid = 0; edgeid < 3; edgeid++) {
+            BorderRecord record = store.Record(edgeid);
+            assert(record.arc == records[edgeid].arc);
+            assert(std::equal(record.values, record.values + 5,
+                              records[edgeid].values));
+            store.Write(edgeid, recorder);
+            assert(recorder.walls.back() ==
+                   std::vector<double>(records[edgeid].values,
+                                       records[edgeid].values +
+                                           (record.arc ? 5 : 4)));
+            assert(recorder.walls.back() ==
+                   recorded_wall(*store.Border(edgeid)));
+        }
+    };
+
+    // Values exact in float are stored in half the space
+    BorderStore single(records);
+    assert(single.Single());
+    check(single);
+    records[2].values[2] = 0.1;
+    BorderStore store(records);
+    assert(!store.Single());
+    check(store);
+    assert(BorderStore::Size(3, 2, 1, true) <
+           BorderStore::Size(3, 2, 1, false));
+    assert(BorderStore::Size(3, 2, 1, false) < 3 * sizeof(BorderRecord));
+
+    // A store over a copied buffer reads the same walls
+    size_t size = BorderStore::Size(3, 2, 1, false);
+    auto buffer = std::make_shared<std::vector<uint64_t>>(size / 8);
+    std::memcpy(buffer->data(), store.Data(), size);
+    check(BorderStore(3, 2, 1, false, std::shared_ptr<const char>(
+        buffer, reinterpret_cast<const char*>(buffer->data()))));
+}
+
+void test_topology_cache() {
+    // Ring of four cells with two boundary walls and an arc
+    auto directory =
+        std::filesystem::temp_directory_path() / "mazegen_test_cache";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+    std::string input = (directory / "ring.xy").string();
+    std::ofstream(input) << "4\n0 1 Line 1 0 1 1\n1 2 Line 1 1 2 1\n"
+                            "2 3 Arc 0 0 1 0 1.5\n3 0 Line 0 1 1 1\n"
+                            "0 -1 Line 0 0 1 0\n2 -1 Line 1 2 2 2\n";
+
+    auto initialise = [&]() {
+        auto maze = std::make_unique<TestableMaze<UserMaze>>(
+            input, directory.string());
+        maze->InitialiseGraph();
+        return maze;
+    };
+    auto edges = [](const Graph& graph) {
+        std::set<std::tuple<int, int, int>> edges;
+        int neighbors[4], edgeids[4];
+        for (int u = 0; u < graph.Vertices(); u++) {
+            int degree = graph.Neighbors(u, neighbors, edgeids);
+            for (int i = 0; i < degree; i++)
+                edges.insert({u, neighbors[i], edgeids[i]});
+        }
+        return edges;
+    };
+
+    auto read = initialise();
+    int files = 0;
+    for (auto& entry : std::filesystem::directory_iterator(directory))
+        files += entry.path().extension() == ".bin";
+    assert(files == 1);
+    auto mapped = initialise();
+    assert(mapped->GetVertexCount() == 4 && mapped->GetEnd() == 3);
+    assert(mapped->GetGraph().Edges() == 6);
+    assert(edges(mapped->GetGraph()) == edges(read->GetGraph()));
+    assert(mapped->GetBoundary() == read->GetBoundary());
+    assert(mapped->GetWalls() == read->GetWalls());
+    assert(recorded_wall(*mapped->Border(2)) ==
+           recorded_wall(*read->Border(2)));
+
+    // Every count and index of the cache is checked when it is loaded. The
+    // header takes 96 bytes and the arrays start at multiples of 8 bytes.
+    std::string cachefile, pristine;
+    for (auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".bin")
+            cachefile = entry.path().string();
+    }
+    {
+        std::ifstream file(cachefile, std::ios::binary);
+        pristine.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    auto field = [&](size_t offset) {
+        int32_t value;
+        std::memcpy(&value, pristine.data() + offset, 4);
+        return value;
+    };
+    auto aligned = [](size_t bytes) { return (bytes + 7) / 8 * 8; };
+    int vertices = field(20), edgecount = field(24), boundaries = field(32);
+    int lines = field(36), arcs = field(40), halfedges = field(56);
+    size_t offsets = 96, neighbors = offsets + aligned(4 * (vertices + 1)),
+           edgeids = neighbors + aligned(4 * halfedges),
+           boundary = edgeids + aligned(4 * halfedges),
+           borders = boundary + aligned(4 * boundaries);
+    auto loads = [&](size_t offset, int32_t value) {
+        std::string damaged = pristine;
+        std::memcpy(&damaged[offset], &value, 4);
+        std::ofstream(cachefile, std::ios::binary) << damaged;
+        TopologyCache::Topology topology;
+        return TopologyCache(directory.string(), 5, 0, input).Load(topology);
+    };
+    assert(loads(offsets, 0));
+    // A degree above the maximum, a precision neither float nor double,
+    // decreasing offsets, then neighbors, edge ids, boundary walls and
+    // border rows out of range
+    std::vector<std::pair<size_t, int32_t>> damages = {
+        {28, 1}, {44, 2}, {offsets + 8, 0}, {neighbors, vertices},
+        {neighbors, -1}, {edgeids, edgecount}, {boundary, edgecount},
+        {boundary, -1}, {borders, lines},
+        {borders, int32_t(0x80000000u | arcs)}};
+    for (auto damage : damages)
+        assert(!loads(damage.first, damage.second));
+    std::ofstream(cachefile, std::ios::binary) << pristine;
+
+    // A damaged cache is read again from the input
+    for (auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".bin")
+            std::filesystem::resize_file(entry.path(), 100);
+    }
+    assert(edges(initialise()->GetGraph()) == edges(read->GetGraph()));
+
+    // A changed input gets a cache of its own
+    std::ofstream(input, std::ios::app) << "1 3 Line 1 1 1 1\n";
+    assert(initialise()->GetGraph().Edges() == 7);
+    files = 0;
+    for (auto& entry : std::filesystem::directory_iterator(directory))
+        files += entry.path().extension() == ".bin";
+    assert(files == 2);
+    std::filesystem::remove_all(directory);
+}
+
+void test_user_maze_parser() {
+    auto directory =
+        std::filesystem::temp_directory_path() / "mazegen_test_parser";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+    std::string input = (directory / "maze.xy").string();
+
+    // Blank lines, carriage returns and a missing final newline are fine, and
+    // edges are numbered in the order of the file
+    std::ofstream(input) << "3\r\n0 1 Line 1 0 1 1\r\n\n  \n"
+                            "1 2 Arc 0 0 1 0 1.5e0\n2 -1 Line +1 2 2 2";
+    TestableMaze<UserMaze> maze(input);
+    maze.InitialiseGraph();
+    assert(maze.GetVertexCount() == 3 && maze.GetGraph().Edges() == 3);
+    assert(maze.GetBoundary() == std::vector<int>{2});
+    int neighbors[2], edgeids[2];
+    assert(maze.GetGraph().Neighbors(1, neighbors, edgeids) == 2);
+    assert(std::set<int>(edgeids, edgeids + 2) == std::set<int>({0, 1}));
+    assert(recorded_wall(*maze.Border(1)) ==
+           std::vector<double>({0, 0, 1, 0, 1.5}));
+
+    // Malformed lines are reported with their line number
+    auto error = [&](const std::string& text) {
+        std::ofstream(input) << text;
+        try {
+            TestableMaze<UserMaze>(input).InitialiseGraph();
+        } catch (const std::invalid_argument& error) {
+            return std::string(error.what()).substr(input.size());
+        }
+        return std::string();
+    };
+    assert(error("x\n").find(":1: ") == 0);
+    assert(error("2\n0 1 Line 0 0 1 1\n\n0 1 Circle 0 0 1\n")
+               .find(":4: unknown border type") == 0);
+    assert(error("2\n0 1 Line 0 0 1\n").find(":2: ") == 0);
+    assert(error("2\n0 1 Line 0 0 1 1 1\n").find(":2: ") == 0);
+    assert(error("2\n0 2 Line 0 0 1 1\n").find(":2: vertex") == 0);
+    std::filesystem::remove_all(directory);
+}
+
 // Main test runner
 int main() {
     TestRunner runner;
@@ -380,6 +1298,27 @@ int main() {
     runner.run_test("DFS Generation", test_dfs_generation);
     runner.run_test("BFS Generation", test_bfs_generation);
     runner.run_test("Kruskal Generation", test_kruskal_generation);
+    runner.run_test("Spanning Tree Edge Ids", test_spanning_tree_edge_ids);
+    runner.run_test("Edge Sink Grows Tree", test_edge_sink_grows_tree);
+    runner.run_test("Parallel Boruvka", test_parallel_boruvka);
+    runner.run_test("Loop-Erased Random Walk Uniform",
+                    test_loop_erased_random_walk_uniform);
+    runner.run_test("Random Generator", test_random);
+    runner.run_test("Seeded Mazes Repeat", test_seeded_mazes_repeat);
+    runner.run_test("Parallel BFS", test_parallel_bfs);
+    runner.run_test("Parallel Cycle Popping", test_cycle_popping);
+    runner.run_test("Tiled Spanning Tree", test_tiled_spanning_tree);
+    runner.run_test("Recursive Division", test_recursive_division);
+    runner.run_test("Row Algorithms", test_row_algorithms);
+    runner.run_test("Streamed Maze Size", test_streamed_maze_size);
+    runner.run_test("Growing Tree", test_growing_tree);
+    runner.run_test("Batch Clones", test_batch_clones);
+    runner.run_test("Generation Reuses Buffers",
+                    test_generation_reuses_buffers);
+    runner.run_test("Buffered Writer", test_buffered_writer);
+    runner.run_test("Border Store", test_border_store);
+    runner.run_test("Topology Cache", test_topology_cache);
+    runner.run_test("User Maze Parser", test_user_maze_parser);
     
     // Comprehensive tests
     runner.run_test("Maze Connectivity After Generation", test_maze_connectivity_after_generation);